@@ -0,0 +1,205 @@
+#include "autosave.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <ctime>
+#include <sys/stat.h>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// ─────────────────────────────────────────────
+//  Oznake izmena (samo UI nit)
+// ─────────────────────────────────────────────
+struct DirtyChunks {
+    std::vector<char>   flag;              // flag[c] = komad c je na listi
+    std::vector<size_t> list;
+    size_t              from = SIZE_MAX;   // izmenjeno sve od ovog zapisa
+
+    bool any() const { return !list.empty() || from != SIZE_MAX; }
+    void clear()
+    {
+        for (size_t c : list) flag[c] = 0;
+        list.clear();
+        from = SIZE_MAX;
+    }
+};
+
+static DirtyChunks dirty[ARR_COUNT];
+static const size_t CHUNK = ChunkedArray<Node>::CHUNK;   // isti za sve nizove
+
+void markDirty(ModelArray a, size_t first, size_t last)
+{
+    DirtyChunks& d = dirty[a];
+    if (last == SIZE_MAX) {
+        if (first < d.from) d.from = first;
+        return;
+    }
+    for (size_t c = first / CHUNK; c * CHUNK < last; c++) {
+        if (c >= d.flag.size()) d.flag.resize(c + 1, 0);
+        if (!d.flag[c]) { d.flag[c] = 1; d.list.push_back(c); }
+    }
+}
+
+void markAllDirty()
+{
+    for (int a = 0; a < ARR_COUNT; a++) markDirty((ModelArray)a, 0);
+}
+
+// ─────────────────────────────────────────────
+//  Snimak: deljenje neobelezenih komada
+// ─────────────────────────────────────────────
+// Vraca false ako je niz isti kao u `prev` (deli se cela tabela)
+template <typename T>
+static bool snapshotArray(const std::vector<T>& src, const ChunkedArray<T>* prev,
+                          DirtyChunks& d, ChunkedArray<T>& dst, int& copied)
+{
+    typedef typename ChunkedArray<T>::Table Table;
+    const size_t C = ChunkedArray<T>::CHUNK;
+    size_t nChunks = (src.size() + C - 1) / C;
+
+    dst.count = src.size();
+    if (prev && !d.any() && prev->count == src.size()) {
+        dst.table = prev->table;
+        return false;
+    }
+
+    // Promenjena duzina: komad na staroj granici i sve iza njega
+    size_t from = 0;
+    if (prev) {
+        from = (d.from == SIZE_MAX) ? nChunks : d.from / C;
+        if (prev->count != src.size())
+            from = std::min(from, std::min(prev->count, src.size()) / C);
+    }
+
+    auto table = std::make_shared<Table>();
+    if (prev) *table = *prev->table;   // samo pokazivaci na komade
+    table->resize(nChunks);
+
+    auto copyChunk = [&](size_t c) {
+        size_t   begin = c * C;
+        size_t   len   = std::min(src.size() - begin, C);
+        const T* data  = src.data() + begin;
+        (*table)[c] = std::make_shared<const std::vector<T>>(data, data + len);
+        copied++;
+    };
+    if (prev)
+        for (size_t c : d.list)
+            if (c < from && c < nChunks) copyChunk(c);
+    for (size_t c = from; c < nChunks; c++) copyChunk(c);
+
+    dst.table = table;
+    d.clear();
+    return true;
+}
+
+std::shared_ptr<const ModelSnapshot> takeSnapshot(const ModelSnapshot* prev, int* copiedChunks)
+{
+    auto snap    = std::make_shared<ModelSnapshot>();
+    int  copied  = 0;
+    bool changed = false;
+    changed |= snapshotArray(app.nodes,     prev ? &prev->nodes     : nullptr, dirty[ARR_NODES],     snap->nodes,     copied);
+    changed |= snapshotArray(app.elements,  prev ? &prev->elements  : nullptr, dirty[ARR_ELEMENTS],  snap->elements,  copied);
+    changed |= snapshotArray(app.supports,  prev ? &prev->supports  : nullptr, dirty[ARR_SUPPORTS],  snap->supports,  copied);
+    changed |= snapshotArray(app.forces,    prev ? &prev->forces    : nullptr, dirty[ARR_FORCES],    snap->forces,    copied);
+    changed |= snapshotArray(app.timeLoads, prev ? &prev->timeLoads : nullptr, dirty[ARR_TIMELOADS], snap->timeLoads, copied);
+    changed |= snapshotArray(app.sections,  prev ? &prev->sections  : nullptr, dirty[ARR_SECTIONS],  snap->sections,  copied);
+
+    if (prev && changed && copied == 0) copied = -1;
+    if (copiedChunks) *copiedChunks = copied;
+    return snap;
+}
+
+// ─────────────────────────────────────────────
+//  Pozadinska nit
+// ─────────────────────────────────────────────
+static std::thread                          worker;
+static std::mutex                           mtx;
+static std::condition_variable              cv;
+static std::shared_ptr<const ModelSnapshot> pending;   // ceka na upis
+static std::shared_ptr<const ModelSnapshot> last;      // poslednji snimak (samo UI nit)
+static bool running  = false;
+static int  nVersions = 3;
+
+static void autosavePath(char* path, size_t size, int version)
+{
+    snprintf(path, size, "MKE-2D.autosave-%d.ulz", version);
+}
+
+// Nastavlja rotaciju iza najnovijeg fajla prethodne sesije
+static int firstVersion()
+{
+    int    newest = -1;
+    time_t newestTime = 0;
+    for (int k = 0; k < nVersions; k++) {
+        char path[64];
+        struct stat st;
+        autosavePath(path, sizeof(path), k);
+        if (stat(path, &st) == 0 && (newest < 0 || st.st_mtime > newestTime)) {
+            newest     = k;
+            newestTime = st.st_mtime;
+        }
+    }
+    return (newest + 1) % nVersions;
+}
+
+static void workerLoop(int version)
+{
+    for (;;) {
+        std::shared_ptr<const ModelSnapshot> snap;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [] { return pending || !running; });
+            if (!pending) return;   // zaustavljeno, nema vise posla
+            snap.swap(pending);
+        }
+
+        char path[64];
+        autosavePath(path, sizeof(path), version);
+        if (saveSnapshot(*snap, path))
+            version = (version + 1) % nVersions;
+        else
+            printf("  [GRESKA] Automatsko cuvanje u %s nije uspelo\n", path);
+    }
+}
+
+void startAutosave(int versions)
+{
+    if (running) return;
+    nVersions = (versions > 0) ? versions : 1;
+    running   = true;
+    worker    = std::thread(workerLoop, firstVersion());
+
+    static bool registered = false;
+    if (!registered) { atexit(stopAutosave); registered = true; }
+}
+
+void autosaveTick()
+{
+    if (!running) return;
+
+    int copied = 0;
+    auto snap = takeSnapshot(last.get(), &copied);
+    if (last && copied == 0) return;   // nista se nije promenilo
+    last = snap;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        pending = snap;   // stariji neupisan snimak se prosto odbacuje
+    }
+    cv.notify_one();
+}
+
+void stopAutosave()
+{
+    autosaveTick();   // izmene posle poslednjeg tajmera
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!running) return;
+        running = false;
+    }
+    cv.notify_one();
+    if (worker.joinable()) worker.join();
+}
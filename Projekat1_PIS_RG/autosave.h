@@ -0,0 +1,53 @@
+#ifndef AUTOSAVE_H
+#define AUTOSAVE_H
+
+#include "utils.h"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// ─────────────────────────────────────────────
+//  Nepromenljivi snimak modela (copy-on-write)
+// ─────────────────────────────────────────────
+// Nizovi se cuvaju u komadima od CHUNK elemenata. Novi snimak deli sa
+// prethodnim svaki komad koji nije obelezen kao izmenjen (markDirty), a
+// niz bez izmena deli i celu tabelu komada, tako da UI nit radi samo sa
+// izmenjenim komadima. Snimak se nikad ne menja, pa ga pozadinska nit
+// moze citati bez zakljucavanja.
+template <typename T>
+struct ChunkedArray {
+    static const size_t CHUNK = 4096;
+    typedef std::vector<std::shared_ptr<const std::vector<T>>> Table;
+
+    std::shared_ptr<const Table> table;
+    size_t count = 0;
+
+    size_t   size() const                 { return count; }
+    const T& operator[](size_t i) const   { return (*(*table)[i / CHUNK])[i % CHUNK]; }
+};
+
+struct ModelSnapshot {
+    ChunkedArray<Node>     nodes;
+    ChunkedArray<Element>  elements;
+    ChunkedArray<Support>  supports;
+    ChunkedArray<Force>    forces;
+    ChunkedArray<TimeLoad> timeLoads;
+    ChunkedArray<Section>  sections;
+};
+
+// Pravi snimak trenutnog `app`, deleci neobelezene komade sa `prev`, i
+// brise oznake izmena. `prev` mora biti prethodni snimak (nullptr = sve se
+// kopira). Vraca i koliko je komada kopirano (-1: izmena bez kopiranja,
+// npr. skracen niz).
+std::shared_ptr<const ModelSnapshot> takeSnapshot(const ModelSnapshot* prev,
+                                                  int* copiedChunks = nullptr);
+
+// Upis snimka (input_output.cpp): privremeni fajl + rename
+bool saveSnapshot(const ModelSnapshot& snap, const char* path);
+
+// Pozadinsko automatsko cuvanje u MKE-2D.autosave-<k>.ulz (k = 0..versions-1)
+void startAutosave(int versions = 3);
+void autosaveTick();   // poziva se periodicno sa UI niti
+void stopAutosave();
+
+#endif
@@ -0,0 +1,435 @@
+#include "utils.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────────
+//  Kompaktni binarni zapis modela (MKE-2D.ulzb)
+// ─────────────────────────────────────────────
+// Koordinate cvorova su na mrezi (snapToGrid), a uglovi oslonaca i sila
+// visekratnici PI/4 (snapAngle), pa se cuvaju kao:
+//   - celobrojne koordinate mreze, delta + zigzag + varint
+//   - uglovi kao oktant (3 bita), uz sirovi float samo ako ugao nije na mrezi
+//   - cvorovi stapa: n1 delta u odnosu na prethodni stap, n2 u odnosu na n1
+//   - sekcija stapa kao indeks u tabeli sekcija (E, A, rho)
+// Nizovi se dele na blokove od BLOCK zapisa koji se kodiraju i dekodiraju
+// nezavisno (paralelno ako je program preveden sa -fopenmp).
+//
+//   "MKEB" verzija
+//   sekcija = varint broj_zapisa, varint broj_blokova,
+//             [varint duzina_bloka]*, [bajtovi bloka]*
+//   CVOROVI | SEKCIJE | STAPOVI | OSLONCI | SILE | DINAMICKE_SILE
+//
+// Raspored je isti kao pre uvodjenja sekcija (tada je tabela bila skup
+// jedinstvenih trojki iz stapova), pa se stari fajlovi citaju bez izmena.
+//
+// Redosled stapova se namerno ne menja, jer broj stapa figurise u izvozu.
+
+static const char    MAGIC[4] = { 'M', 'K', 'E', 'B' };
+static const uint8_t VERSION  = 2;
+static const size_t  BLOCK    = 65536;
+static const float   GRID     = 1.0f;            // isti korak kao snapToGrid
+static const float   ANGLE_STEP = (float)M_PI / 4.0f;
+
+// ── varint / zigzag ──────────────────────────────────────────
+static void putVarint(std::string& out, uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back((char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((char)v);
+}
+
+static bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p >= end) return false;
+        uint8_t b = *p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static uint64_t zigzag(int64_t v)    { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t  unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+static void putFloat(std::string& out, float v)
+{
+    char b[4];
+    memcpy(b, &v, 4);
+    out.append(b, 4);
+}
+
+static bool getFloat(const uint8_t*& p, const uint8_t* end, float& v)
+{
+    if (end - p < 4) return false;
+    memcpy(&v, p, 4);
+    p += 4;
+    return true;
+}
+
+// Oktant 0..7 ako je ugao na mrezi PI/4, inace -1
+static int angleOctant(float angle)
+{
+    float k = roundf(angle / ANGLE_STEP);
+    if (fabsf(angle - k * ANGLE_STEP) > 1e-5f) return -1;
+    return (((int)k % 8) + 8) % 8;
+}
+
+// ── Blokovi ──────────────────────────────────────────────────
+// encode(begin, end, out) kodira zapise [begin, end) u jedan blok
+template <typename Encode>
+static void putSection(std::string& out, size_t count, Encode encode)
+{
+    size_t nBlocks = (count + BLOCK - 1) / BLOCK;
+    std::vector<std::string> blocks(nBlocks);
+
+    #pragma omp parallel for schedule(dynamic)
+    for (long b = 0; b < (long)nBlocks; b++) {
+        size_t begin = (size_t)b * BLOCK;
+        size_t end   = (begin + BLOCK < count) ? begin + BLOCK : count;
+        encode(begin, end, blocks[b]);
+    }
+
+    putVarint(out, count);
+    putVarint(out, nBlocks);
+    for (const std::string& s : blocks) putVarint(out, s.size());
+    for (const std::string& s : blocks) out += s;
+}
+
+// decode(begin, end, p, pEnd) dekodira zapise [begin, end); false = ostecen blok.
+// minBytes je najmanja duzina jednog zapisa: broj zapisa i blokova iz fajla
+// se proveravaju prema preostalim bajtovima pre bilo kakve alokacije.
+template <typename Decode, typename Resize>
+static bool getSection(const uint8_t*& p, const uint8_t* end, size_t& count,
+                       size_t minBytes, Decode decode, Resize resize)
+{
+    uint64_t n, nBlocks;
+    if (!getVarint(p, end, n) || !getVarint(p, end, nBlocks)) return false;
+    if (nBlocks != n / BLOCK + (n % BLOCK != 0)) return false;
+    if (nBlocks > (uint64_t)(end - p)) return false;   // bar bajt po duzini bloka
+
+    std::vector<uint64_t> offs(nBlocks + 1, 0);
+    for (uint64_t b = 0; b < nBlocks; b++) {
+        uint64_t len;
+        if (!getVarint(p, end, len) || len > (uint64_t)(end - p)) return false;
+        offs[b + 1] = offs[b] + len;
+        if (offs[b + 1] > (uint64_t)(end - p)) return false;
+    }
+    if (n > offs[nBlocks] / minBytes) return false;
+
+    count = (size_t)n;
+    resize(count);
+
+    bool ok = true;
+    #pragma omp parallel for schedule(dynamic) reduction(&&:ok)
+    for (long b = 0; b < (long)nBlocks; b++) {
+        size_t begin = (size_t)b * BLOCK;
+        size_t last  = (begin + BLOCK < count) ? begin + BLOCK : count;
+        const uint8_t* q    = p + offs[b];
+        const uint8_t* qEnd = p + offs[b + 1];
+        ok = decode(begin, last, q, qEnd) && q == qEnd && ok;
+    }
+    p += offs[nBlocks];
+    return ok;
+}
+
+// ─────────────────────────────────────────────
+//  saveCompact
+// ─────────────────────────────────────────────
+bool saveCompact(const char* path)
+{
+    std::string out(MAGIC, 4);
+    out.push_back((char)VERSION);
+
+    // ── Cvorovi ───────────────────────────────────────────────
+    // Ako i jedan cvor nije na mrezi, sve koordinate idu kao float
+    bool onGrid = true;
+    for (const Node& n : app.nodes)
+        if (n.x != roundf(n.x / GRID) * GRID || n.y != roundf(n.y / GRID) * GRID)
+            { onGrid = false; break; }
+    out.push_back(onGrid ? 1 : 0);
+
+    putSection(out, app.nodes.size(), [&](size_t b, size_t e, std::string& s) {
+        int64_t px = 0, py = 0;
+        for (size_t i = b; i < e; i++) {
+            if (onGrid) {
+                int64_t ix = (int64_t)roundf(app.nodes[i].x / GRID);
+                int64_t iy = (int64_t)roundf(app.nodes[i].y / GRID);
+                putVarint(s, zigzag(ix - px));
+                putVarint(s, zigzag(iy - py));
+                px = ix; py = iy;
+            } else {
+                putFloat(s, app.nodes[i].x);
+                putFloat(s, app.nodes[i].y);
+            }
+        }
+    });
+
+    // ── Sekcije ───────────────────────────────────────────────
+    putVarint(out, app.sections.size());
+    for (const Section& sc : app.sections) { putFloat(out, sc.E); putFloat(out, sc.A); putFloat(out, sc.rho); }
+
+    // ── Stapovi ───────────────────────────────────────────────
+    putSection(out, app.elements.size(), [&](size_t b, size_t e, std::string& s) {
+        int64_t prev = 0;
+        for (size_t i = b; i < e; i++) {
+            int64_t n1 = app.elements[i].n1, n2 = app.elements[i].n2;
+            putVarint(s, zigzag(n1 - prev));
+            putVarint(s, zigzag(n2 - n1));
+            putVarint(s, app.elements[i].section);
+            prev = n1;
+        }
+    });
+
+    // ── Oslonci: bit 0 = tip, bitovi 1-3 = oktant, bit 4 = sirov ugao ─
+    putSection(out, app.supports.size(), [&](size_t b, size_t e, std::string& s) {
+        int64_t prev = 0;
+        for (size_t i = b; i < e; i++) {
+            const Support& sp = app.supports[i];
+            int oct = angleOctant(sp.angle);
+            putVarint(s, zigzag(sp.node - prev));
+            s.push_back((char)((sp.type == ROLLER ? 1 : 0) |
+                               (oct >= 0 ? oct << 1 : 0x10)));
+            if (oct < 0) putFloat(s, sp.angle);
+            prev = sp.node;
+        }
+    });
+
+    // ── Sile: bitovi 0-2 = oktant, bit 3 = sirov ugao ─────────
+    putSection(out, app.forces.size(), [&](size_t b, size_t e, std::string& s) {
+        int64_t prev = 0;
+        for (size_t i = b; i < e; i++) {
+            const Force& fc = app.forces[i];
+            int oct = angleOctant(fc.angle);
+            putVarint(s, zigzag(fc.node - prev));
+            s.push_back((char)(oct >= 0 ? oct : 0x08));
+            if (oct < 0) putFloat(s, fc.angle);
+            putFloat(s, fc.magnitude);
+            prev = fc.node;
+        }
+    });
+
+    // ── Dinamicke sile: kao sile, pa varint broj tacaka i (t, F) ─
+    putSection(out, app.timeLoads.size(), [&](size_t b, size_t e, std::string& s) {
+        int64_t prev = 0;
+        for (size_t i = b; i < e; i++) {
+            const TimeLoad& tl = app.timeLoads[i];
+            int oct = angleOctant(tl.angle);
+            putVarint(s, zigzag(tl.node - prev));
+            s.push_back((char)(oct >= 0 ? oct : 0x08));
+            if (oct < 0) putFloat(s, tl.angle);
+            putVarint(s, tl.t.size());
+            for (size_t k = 0; k < tl.t.size(); k++) { putFloat(s, tl.t[k]); putFloat(s, tl.F[k]); }
+            prev = tl.node;
+        }
+    });
+
+    // Privremeni fajl + rename, kao i tekstualni izvoz
+    std::string tmp = std::string(path) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "wb");
+    if (!f) {
+        printf("  [GRESKA] Nije moguce otvoriti %s za pisanje!\n", tmp.c_str());
+        return false;
+    }
+    bool ok = fwrite(out.data(), 1, out.size(), f) == out.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmp.c_str(), path) != 0) {
+        remove(tmp.c_str());
+        printf("  [GRESKA] Upis u %s nije uspeo!\n", path);
+        return false;
+    }
+    printf("\n  [OK] Sacuvano u %s (%zu bajtova)\n\n", path, out.size());
+    return true;
+}
+
+// ─────────────────────────────────────────────
+//  loadCompact
+// ─────────────────────────────────────────────
+bool loadCompact(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        printf("  [GRESKA] Nije moguce otvoriti %s!\n", path);
+        return false;
+    }
+    std::vector<uint8_t> buf;
+    uint8_t chunk[1 << 16];
+    size_t  n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        buf.insert(buf.end(), chunk, chunk + n);
+    fclose(f);
+
+    const uint8_t* p   = buf.data();
+    const uint8_t* end = p + buf.size();
+    auto fail = [&]() {
+        printf("  [GRESKA] %s nije ispravan kompaktni fajl modela!\n", path);
+        return false;
+    };
+    if (buf.size() < 6 || memcmp(p, MAGIC, 4) != 0 || p[4] != VERSION) return fail();
+    bool onGrid = p[5] != 0;
+    p += 6;
+
+    // Dekodira se u privremene nizove, `app` se menja tek na kraju
+    std::vector<Node>    nodes;
+    std::vector<Element> elements;
+    std::vector<Support> supports;
+    std::vector<Force>   forces;
+    std::vector<TimeLoad> timeLoads;
+    size_t nN = 0, nE = 0, nS = 0, nF = 0, nT = 0;
+
+    // ── Cvorovi ───────────────────────────────────────────────
+    if (!getSection(p, end, nN, onGrid ? 2 : 8,
+            [&](size_t b, size_t e, const uint8_t*& q, const uint8_t* qEnd) {
+                int64_t px = 0, py = 0;
+                for (size_t i = b; i < e; i++) {
+                    if (onGrid) {
+                        uint64_t dx, dy;
+                        if (!getVarint(q, qEnd, dx) || !getVarint(q, qEnd, dy)) return false;
+                        px += unzigzag(dx);
+                        py += unzigzag(dy);
+                        nodes[i].x = (float)px * GRID;
+                        nodes[i].y = (float)py * GRID;
+                    } else if (!getFloat(q, qEnd, nodes[i].x) ||
+                               !getFloat(q, qEnd, nodes[i].y)) {
+                        return false;
+                    }
+                }
+                return true;
+            },
+            [&](size_t c) { nodes.resize(c); }))
+        return fail();
+
+    // ── Sekcije ───────────────────────────────────────────────
+    uint64_t nMats;
+    if (!getVarint(p, end, nMats) || nMats > (uint64_t)(end - p) / 12 ||
+        nMats > (uint64_t)MAX_SECTIONS) return fail();
+    std::vector<Section> sections(nMats);
+    for (Section& sc : sections)
+        if (!getFloat(p, end, sc.E) || !getFloat(p, end, sc.A) || !getFloat(p, end, sc.rho))
+            return fail();
+
+    // ── Stapovi ───────────────────────────────────────────────
+    if (!getSection(p, end, nE, 3,
+            [&](size_t b, size_t e, const uint8_t*& q, const uint8_t* qEnd) {
+                int64_t prev = 0;
+                for (size_t i = b; i < e; i++) {
+                    uint64_t d1, d2, m;
+                    if (!getVarint(q, qEnd, d1) || !getVarint(q, qEnd, d2) ||
+                        !getVarint(q, qEnd, m)) return false;
+                    int64_t n1 = prev + unzigzag(d1);
+                    int64_t n2 = n1 + unzigzag(d2);
+                    if (n1 < 0 || n2 < 0 || n1 >= (int64_t)nN || n2 >= (int64_t)nN ||
+                        m >= nMats) return false;
+                    elements[i].n1 = (int)n1;
+                    elements[i].n2 = (int)n2;
+                    elements[i].section = (uint16_t)m;
+                    prev = n1;
+                }
+                return true;
+            },
+            [&](size_t c) { elements.resize(c); }))
+        return fail();
+
+    // ── Oslonci ───────────────────────────────────────────────
+    if (!getSection(p, end, nS, 2,
+            [&](size_t b, size_t e, const uint8_t*& q, const uint8_t* qEnd) {
+                int64_t prev = 0;
+                for (size_t i = b; i < e; i++) {
+                    uint64_t d;
+                    if (!getVarint(q, qEnd, d) || q >= qEnd) return false;
+                    int64_t node = prev + unzigzag(d);
+                    uint8_t code = *q++;
+                    if (node < 0 || node >= (int64_t)nN) return false;
+                    supports[i].node = (int)node;
+                    supports[i].type = (code & 1) ? ROLLER : FIXED;
+                    if (code & 0x10) {
+                        if (!getFloat(q, qEnd, supports[i].angle)) return false;
+                    } else {
+                        supports[i].angle = ((code >> 1) & 7) * ANGLE_STEP;
+                    }
+                    prev = node;
+                }
+                return true;
+            },
+            [&](size_t c) { supports.resize(c); }))
+        return fail();
+
+    // ── Sile ──────────────────────────────────────────────────
+    if (!getSection(p, end, nF, 6,
+            [&](size_t b, size_t e, const uint8_t*& q, const uint8_t* qEnd) {
+                int64_t prev = 0;
+                for (size_t i = b; i < e; i++) {
+                    uint64_t d;
+                    if (!getVarint(q, qEnd, d) || q >= qEnd) return false;
+                    int64_t node = prev + unzigzag(d);
+                    uint8_t code = *q++;
+                    if (node < 0 || node >= (int64_t)nN) return false;
+                    forces[i].node = (int)node;
+                    if (code & 0x08) {
+                        if (!getFloat(q, qEnd, forces[i].angle)) return false;
+                    } else {
+                        forces[i].angle = (code & 7) * ANGLE_STEP;
+                    }
+                    if (!getFloat(q, qEnd, forces[i].magnitude)) return false;
+                    prev = node;
+                }
+                return true;
+            },
+            [&](size_t c) { forces.resize(c); }))
+        return fail();
+
+    // ── Dinamicke sile ────────────────────────────────────────
+    if (!getSection(p, end, nT, 3,
+            [&](size_t b, size_t e, const uint8_t*& q, const uint8_t* qEnd) {
+                int64_t prev = 0;
+                for (size_t i = b; i < e; i++) {
+                    uint64_t d, nPts;
+                    if (!getVarint(q, qEnd, d) || q >= qEnd) return false;
+                    int64_t node = prev + unzigzag(d);
+                    uint8_t code = *q++;
+                    if (node < 0 || node >= (int64_t)nN) return false;
+                    TimeLoad& tl = timeLoads[i];
+                    tl.node = (int)node;
+                    if (code & 0x08) {
+                        if (!getFloat(q, qEnd, tl.angle)) return false;
+                    } else {
+                        tl.angle = (code & 7) * ANGLE_STEP;
+                    }
+                    // Svaka tacka je 8 bajtova — broj se proverava pre alokacije
+                    if (!getVarint(q, qEnd, nPts) || nPts > (uint64_t)(qEnd - q) / 8)
+                        return false;
+                    tl.t.resize(nPts);
+                    tl.F.resize(nPts);
+                    for (size_t k = 0; k < nPts; k++)
+                        if (!getFloat(q, qEnd, tl.t[k]) || !getFloat(q, qEnd, tl.F[k]))
+                            return false;
+                    prev = node;
+                }
+                return true;
+            },
+            [&](size_t c) { timeLoads.resize(c); }))
+        return fail();
+
+    if (p != end) return fail();
+
+    app.nodes.swap(nodes);
+    app.elements.swap(elements);
+    app.supports.swap(supports);
+    app.forces.swap(forces);
+    app.timeLoads.swap(timeLoads);
+    if (sections.empty()) sections.push_back({ 210e9f, 1e-3f, 7850.0f });
+    app.sections.swap(sections);
+    if (app.currentSection >= app.sections.size()) app.currentSection = 0;
+    sectionsChanged();
+    markAllDirty();
+    printf("\n  [OK] Ucitano iz %s: %zu cvorova, %zu stapova, %zu oslonaca, %zu sila\n\n",
+           path, nN, nE, nS, nF + nT);
+    return true;
+}
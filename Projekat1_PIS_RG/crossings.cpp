@@ -0,0 +1,504 @@
+#include "crossings.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <queue>
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+
+// ─────────────────────────────────────────────
+//  Tacna geometrija na celobrojnoj mrezi
+// ─────────────────────────────────────────────
+// Koordinate su u [0, 2^24), razlike i smerovi |d| < 2^24. Tacka preseka
+// ima imenilac |den| < 2^49 i brojioce < 2^74, pa poredjenje dve tacke
+// (unakrsno mnozenje) ostaje ispod 2^124 — staje u __int128.
+typedef __int128 i128;
+
+static const int GRID_BITS = 24;
+
+struct RPoint { i128 x, y, d; };   // (x / d, y / d), d > 0
+
+struct Seg {
+    int64_t px, py, qx, qy;        // P < Q leksikografski (x, pa y)
+    int     elem;
+    int     nodeP, nodeQ;
+};
+
+static bool ptLess(const RPoint& a, const RPoint& b)
+{
+    i128 l = a.x * b.d, r = b.x * a.d;
+    if (l != r) return l < r;
+    return a.y * b.d < b.y * a.d;
+}
+
+static bool ptEqual(const RPoint& a, const RPoint& b)
+{
+    return a.x * b.d == b.x * a.d && a.y * b.d == b.y * a.d;
+}
+
+// > 0: tacka je levo od P→Q (iznad stapa), 0: na pravoj stapa
+static int orient(const Seg& s, const RPoint& p)
+{
+    i128 dx = s.qx - s.px, dy = s.qy - s.py;
+    i128 c  = dx * (p.y - (i128)s.py * p.d) - dy * (p.x - (i128)s.px * p.d);
+    return (c > 0) - (c < 0);
+}
+
+static int orient(const Seg& s, int64_t x, int64_t y)
+{
+    i128 c = (i128)(s.qx - s.px) * (y - s.py) - (i128)(s.qy - s.py) * (x - s.px);
+    return (c > 0) - (c < 0);
+}
+
+// > 0: smer b je u smeru suprotnom kazaljci od smera a
+static int turn(const Seg& a, const Seg& b)
+{
+    i128 c = (i128)(a.qx - a.px) * (b.qy - b.py) - (i128)(a.qy - a.py) * (b.qx - b.px);
+    return (c > 0) - (c < 0);
+}
+
+// ─────────────────────────────────────────────
+//  Stanje preseka: treap sa roditeljskim pokazivacima
+// ─────────────────────────────────────────────
+// Redosled stapova odozdo nagore duz linije brisanja. Poredjenje se radi
+// samo pri trazenju tacke (orijentacija); umetanje i brisanje idu preko
+// rucke, pa se stapovi nikad ne porede u racionalnoj tacki preseka.
+struct Status {
+    struct TNode { int seg, left, right, parent; uint32_t prio; };
+    std::vector<TNode> t;
+    std::vector<int>   freeList;
+    int      root = -1;
+    uint32_t rng  = 2463534242u;
+
+    uint32_t random() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return rng; }
+
+    int leftmost(int h) const  { while (t[h].left  != -1) h = t[h].left;  return h; }
+    int rightmost(int h) const { while (t[h].right != -1) h = t[h].right; return h; }
+    int last() const           { return root < 0 ? -1 : rightmost(root); }
+
+    int next(int h) const
+    {
+        if (t[h].right != -1) return leftmost(t[h].right);
+        int p = t[h].parent;
+        while (p != -1 && t[p].right == h) { h = p; p = t[p].parent; }
+        return p;
+    }
+
+    int prev(int h) const
+    {
+        if (t[h].left != -1) return rightmost(t[h].left);
+        int p = t[h].parent;
+        while (p != -1 && t[p].left == h) { h = p; p = t[p].parent; }
+        return p;
+    }
+
+    // x postaje roditelj svog roditelja
+    void rotateUp(int x)
+    {
+        int p = t[x].parent, g = t[p].parent;
+        if (t[p].left == x) {
+            t[p].left = t[x].right;
+            if (t[x].right != -1) t[t[x].right].parent = p;
+            t[x].right = p;
+        } else {
+            t[p].right = t[x].left;
+            if (t[x].left != -1) t[t[x].left].parent = p;
+            t[x].left = p;
+        }
+        t[p].parent = x;
+        t[x].parent = g;
+        if (g == -1)               root = x;
+        else if (t[g].left == p)   t[g].left = x;
+        else                       t[g].right = x;
+    }
+
+    // Umece stap odmah iznad rucke h (h = -1: na dno)
+    int insertAfter(int h, int seg)
+    {
+        int x;
+        if (!freeList.empty()) { x = freeList.back(); freeList.pop_back(); }
+        else                   { x = (int)t.size(); t.push_back(TNode()); }
+        t[x] = TNode{ seg, -1, -1, -1, random() };
+
+        if (root == -1) { root = x; return x; }
+        if (h == -1) {
+            int f = leftmost(root);
+            t[f].left = x; t[x].parent = f;
+        } else if (t[h].right == -1) {
+            t[h].right = x; t[x].parent = h;
+        } else {
+            int f = leftmost(t[h].right);
+            t[f].left = x; t[x].parent = f;
+        }
+        while (t[x].parent != -1 && t[t[x].parent].prio < t[x].prio) rotateUp(x);
+        return x;
+    }
+
+    void erase(int x)
+    {
+        while (t[x].left != -1 || t[x].right != -1) {
+            int c;
+            if      (t[x].left  == -1) c = t[x].right;
+            else if (t[x].right == -1) c = t[x].left;
+            else c = (t[t[x].left].prio > t[t[x].right].prio) ? t[x].left : t[x].right;
+            rotateUp(c);
+        }
+        int p = t[x].parent;
+        if (p == -1)               root = -1;
+        else if (t[p].left == x)   t[p].left = -1;
+        else                       t[p].right = -1;
+        freeList.push_back(x);
+    }
+};
+
+// ─────────────────────────────────────────────
+//  findCrossings
+// ─────────────────────────────────────────────
+struct Endpoint {
+    int64_t x, y;
+    int     seg;
+    bool    left;
+};
+
+struct Sweep {
+    std::vector<Seg>   segs;
+    Status             st;
+    std::vector<int>   handle;     // rucka stapa u stanju, -1 = nije aktivan
+    std::priority_queue<RPoint, std::vector<RPoint>,
+                        bool (*)(const RPoint&, const RPoint&)> events;
+    std::unordered_set<uint64_t> seenPair;
+    double x0 = 0.0, y0 = 0.0, scale = 1.0;
+    std::vector<Crossing>* out = nullptr;
+
+    Sweep() : events([](const RPoint& a, const RPoint& b) { return ptLess(b, a); }) {}
+
+    int segAt(int h) const { return st.t[h].seg; }
+
+    // Najnizi aktivan stap na kome je ili iznad koga je p
+    int locate(const RPoint& p) const
+    {
+        int h = st.root, cand = -1;
+        while (h != -1) {
+            if (orient(segs[st.t[h].seg], p) > 0) h = st.t[h].right;
+            else { cand = h; h = st.t[h].left; }
+        }
+        return cand;
+    }
+
+    // Presek unutrasnjosti dva susedna stapa desno od p postaje dogadjaj
+    void checkPair(int s1, int s2, const RPoint& p)
+    {
+        const Seg& a = segs[s1];
+        const Seg& b = segs[s2];
+        int o1 = orient(a, b.px, b.py), o2 = orient(a, b.qx, b.qy);
+        int o3 = orient(b, a.px, a.py), o4 = orient(b, a.qx, a.qy);
+        if (o1 * o2 >= 0 || o3 * o4 >= 0) return;   // dodiri se nalaze u krajevima
+
+        i128 dax = a.qx - a.px, day = a.qy - a.py;
+        i128 dbx = b.qx - b.px, dby = b.qy - b.py;
+        i128 den = dax * dby - day * dbx;
+        i128 num = (i128)(b.px - a.px) * dby - (i128)(b.py - a.py) * dbx;
+        RPoint q = { (i128)a.px * den + num * dax, (i128)a.py * den + num * day, den };
+        if (q.d < 0) { q.x = -q.x; q.y = -q.y; q.d = -q.d; }
+        if (ptLess(p, q)) events.push(q);
+    }
+
+    void report(CrossKind kind, int sa, int sb, int node, const RPoint& p)
+    {
+        int ea = segs[sa].elem, eb = segs[sb].elem;
+        // Kraj jednog stapa je unutar drugog samo u jednoj tacki dogadjaja,
+        // pa se preklapanja ne ponavljaju; presek/dodir se ponavlja kad se
+        // isti par sretne vise puta (susedi posle umetanja)
+        if (kind != CROSS_OVERLAP) {
+            uint32_t lo = (uint32_t)std::min(ea, eb), hi = (uint32_t)std::max(ea, eb);
+            if (!seenPair.insert(((uint64_t)lo << 32) | hi).second) return;
+        }
+
+        // Skracen razlomak → ista tacka uvek daje iste float koordinate
+        i128 g = p.d, u = p.x < 0 ? -p.x : p.x, v = p.y < 0 ? -p.y : p.y;
+        while (u != 0) { i128 r = g % u; g = u; u = r; }
+        while (v != 0) { i128 r = g % v; g = v; v = r; }
+        Crossing c;
+        c.a    = ea;
+        c.b    = eb;
+        c.kind = kind;
+        c.node = node;
+        c.x    = (float)((double)(p.x / g) / (double)(p.d / g) / scale + x0);
+        c.y    = (float)((double)(p.y / g) / (double)(p.d / g) / scale + y0);
+        out->push_back(c);
+    }
+
+    int nodeAt(int s, const RPoint& p) const
+    {
+        const Seg& g = segs[s];
+        return ptEqual(RPoint{ g.px, g.py, 1 }, p) ? g.nodeP : g.nodeQ;
+    }
+};
+
+void findCrossings(std::vector<Crossing>& out)
+{
+    out.clear();
+    const int nN = (int)app.nodes.size();
+    const int nE = (int)app.elements.size();
+    if (nE < 2) return;
+
+    Sweep sw;
+    sw.out = &out;
+
+    double x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+    for (const Node& n : app.nodes) {
+        x0 = std::min(x0, (double)n.x); x1 = std::max(x1, (double)n.x);
+        y0 = std::min(y0, (double)n.y); y1 = std::max(y1, (double)n.y);
+    }
+    double extent = std::max(x1 - x0, y1 - y0);
+    sw.x0    = x0;
+    sw.y0    = y0;
+    // Korak mreze je stepen dvojke: cvorovi sa celobrojne mreze editora
+    // (i njene polovine, cetvrtine...) se preslikavaju tacno, pa kolinearni
+    // cvorovi ostaju kolinearni
+    int k = 0;
+    if (extent > 0.0) frexp((double)((1 << GRID_BITS) - 1) / extent, &k);
+    sw.scale = ldexp(1.0, k - 1);
+
+    std::vector<int64_t> gx(nN), gy(nN);
+    for (int i = 0; i < nN; i++) {
+        gx[i] = llround((app.nodes[i].x - x0) * sw.scale);
+        gy[i] = llround((app.nodes[i].y - y0) * sw.scale);
+    }
+
+    // Stapovi koji se na mrezi svode na tacku se preskacu (nulta duzina se
+    // prijavljuje u proveri modela)
+    std::vector<Endpoint> ends;
+    sw.segs.reserve(nE);
+    ends.reserve(2 * (size_t)nE);
+    for (int i = 0; i < nE; i++) {
+        const Element& e = app.elements[i];
+        Seg s = { gx[e.n1], gy[e.n1], gx[e.n2], gy[e.n2], i, e.n1, e.n2 };
+        if (s.px == s.qx && s.py == s.qy) continue;
+        if (s.qx < s.px || (s.qx == s.px && s.qy < s.py)) {
+            std::swap(s.px, s.qx); std::swap(s.py, s.qy); std::swap(s.nodeP, s.nodeQ);
+        }
+        int id = (int)sw.segs.size();
+        sw.segs.push_back(s);
+        ends.push_back({ s.px, s.py, id, true });
+        ends.push_back({ s.qx, s.qy, id, false });
+    }
+    std::sort(ends.begin(), ends.end(), [](const Endpoint& a, const Endpoint& b) {
+        return a.x != b.x ? a.x < b.x : a.y < b.y;
+    });
+    sw.handle.assign(sw.segs.size(), -1);
+
+    std::vector<int> U, B, I, E, C;
+    size_t ei = 0;
+    while (ei < ends.size() || !sw.events.empty()) {
+        RPoint p;
+        if (ei < ends.size()) {
+            p = RPoint{ ends[ei].x, ends[ei].y, 1 };
+            if (!sw.events.empty() && ptLess(sw.events.top(), p)) p = sw.events.top();
+        } else {
+            p = sw.events.top();
+        }
+        while (!sw.events.empty() && ptEqual(sw.events.top(), p)) sw.events.pop();
+
+        U.clear();
+        while (ei < ends.size() && ptEqual(RPoint{ ends[ei].x, ends[ei].y, 1 }, p)) {
+            if (ends[ei].left) U.push_back(ends[ei].seg);
+            ei++;
+        }
+
+        // Aktivni stapovi kroz p su uzastopni u stanju
+        int cand = sw.locate(p);
+        B.clear();
+        int h = cand;
+        while (h != -1 && orient(sw.segs[sw.segAt(h)], p) == 0) {
+            B.push_back(sw.segAt(h));
+            h = sw.st.next(h);
+        }
+        int hi = h;
+        int lo = (cand != -1) ? sw.st.prev(cand) : sw.st.last();
+
+        // I: p unutar stapa, E: p je kraj stapa
+        I.clear(); E.clear();
+        for (int s : B) {
+            const Seg& g = sw.segs[s];
+            if (ptEqual(RPoint{ g.qx, g.qy, 1 }, p)) E.push_back(s);
+            else                                     I.push_back(s);
+        }
+        E.insert(E.end(), U.begin(), U.end());
+
+        if (I.size() + E.size() >= 2) {
+            // Kolinearni par kroz p je preklapanje; belezi se u kraju koji
+            // lezi unutar drugog stapa (tamo gde se deli)
+            for (size_t i = 0; i < I.size(); i++)
+                for (size_t j = i + 1; j < I.size(); j++)
+                    if (turn(sw.segs[I[i]], sw.segs[I[j]]) != 0)
+                        sw.report(CROSS_PROPER, I[i], I[j], -1, p);
+            for (int a : I)
+                for (int e : E)
+                    sw.report(turn(sw.segs[a], sw.segs[e]) == 0 ? CROSS_OVERLAP : CROSS_TOUCH,
+                              a, e, sw.nodeAt(e, p), p);
+            bool sameNode = true;
+            for (size_t i = 1; i < E.size() && sameNode; i++)
+                sameNode = sw.nodeAt(E[i], p) == sw.nodeAt(E[0], p);
+            if (!sameNode)
+                for (size_t i = 0; i < E.size(); i++)
+                    for (size_t j = i + 1; j < E.size(); j++)
+                        if (sw.nodeAt(E[i], p) != sw.nodeAt(E[j], p))
+                            sw.report(CROSS_TOUCH, E[i], E[j], -1, p);
+        }
+
+        // Stapovi kroz p se vade i vracaju u redosledu desno od p
+        for (int s : B) { sw.st.erase(sw.handle[s]); sw.handle[s] = -1; }
+        C = I;
+        C.insert(C.end(), U.begin(), U.end());
+        std::sort(C.begin(), C.end(), [&](int a, int b) {
+            int o = turn(sw.segs[a], sw.segs[b]);
+            return o != 0 ? o > 0 : a < b;
+        });
+        int prevH = lo;
+        for (int s : C) prevH = sw.handle[s] = sw.st.insertAfter(prevH, s);
+
+        if (C.empty()) {
+            if (lo != -1 && hi != -1) sw.checkPair(sw.segAt(lo), sw.segAt(hi), p);
+        } else {
+            if (lo != -1) sw.checkPair(sw.segAt(lo), C.front(), p);
+            if (hi != -1) sw.checkPair(C.back(), sw.segAt(hi), p);
+        }
+    }
+}
+
+static std::string nodeLabel(int i)
+{
+    std::string s;
+    do {
+        s = (char)('A' + (i % 26)) + s;
+        i = i / 26 - 1;
+    } while (i >= 0);
+    return s;
+}
+
+// ─────────────────────────────────────────────
+//  splitCrossings
+// ─────────────────────────────────────────────
+int splitCrossings(const std::vector<Crossing>& found)
+{
+    const int nE0 = (int)app.elements.size();
+    std::vector<std::vector<int>> cuts(nE0);
+
+    // Isti presek vise parova dobija jedan cvor
+    std::unordered_map<uint64_t, int> newNode;
+    auto nodeFor = [&](float x, float y) {
+        uint32_t bx, by;
+        memcpy(&bx, &x, 4);
+        memcpy(&by, &y, 4);
+        uint64_t key = ((uint64_t)bx << 32) | by;
+        auto it = newNode.find(key);
+        if (it != newNode.end()) return it->second;
+        app.nodes.push_back({ x, y });
+        int id = (int)app.nodes.size() - 1;
+        newNode[key] = id;
+        return id;
+    };
+
+    int nNodes0 = (int)app.nodes.size();
+    for (const Crossing& c : found) {
+        if (c.a >= nE0 || c.b >= nE0) continue;
+        if (c.kind == CROSS_PROPER) {
+            int n = nodeFor(c.x, c.y);
+            cuts[c.a].push_back(n);
+            cuts[c.b].push_back(n);
+        } else if (c.node >= 0) {
+            cuts[c.a].push_back(c.node);
+        }
+    }
+
+    std::vector<Element> pieces;
+    std::vector<char>    isPiece(nE0, 0);   // stap je nastao ovom podelom
+    for (int i = 0; i < nE0; i++) {
+        if (cuts[i].empty()) continue;
+        const Element e = app.elements[i];
+        const Node& A = app.nodes[e.n1];
+        const Node& B = app.nodes[e.n2];
+        double dx = B.x - A.x, dy = B.y - A.y, L2 = dx*dx + dy*dy;
+
+        std::vector<std::pair<double, int>> along;
+        for (int n : cuts[i]) {
+            if (n == e.n1 || n == e.n2) continue;
+            double t = ((app.nodes[n].x - A.x) * dx + (app.nodes[n].y - A.y) * dy) / L2;
+            along.push_back({ t, n });
+        }
+        if (along.empty()) continue;
+        std::sort(along.begin(), along.end());
+        along.erase(std::unique(along.begin(), along.end(),
+                                [](const std::pair<double, int>& p, const std::pair<double, int>& q) {
+                                    return p.second == q.second;
+                                }),
+                    along.end());
+
+        // Prvi deo ostaje na mestu stapa, ostali se dodaju na kraj
+        int from = e.n1;
+        for (size_t k = 0; k < along.size(); k++) {
+            Element piece = { from, along[k].second, e.section };
+            if (k == 0) {
+                app.elements[i] = piece;
+                isPiece[i]      = 1;
+                markDirty(ARR_ELEMENTS, i, i + 1);
+            }
+            else        pieces.push_back(piece);
+            from = along[k].second;
+        }
+        pieces.push_back({ from, e.n2, e.section });
+    }
+    app.elements.insert(app.elements.end(), pieces.begin(), pieces.end());
+    isPiece.resize(app.elements.size(), 1);
+
+    // Preklopljeni delovi postaju isti par cvorova — zadrzava se prvi.
+    // Izbacuje se samo par u kome je bar jedan stap deo ove podele; stapovi
+    // koji su vec bili duplirani ostaju (provera modela ih prijavljuje).
+    std::unordered_map<uint64_t, size_t> kept;   // par cvorova → zadrzan stap
+    kept.reserve(2 * app.elements.size());
+    size_t w = 0;
+    int nConflict = 0;
+    for (size_t i = 0; i < app.elements.size(); i++) {
+        const Element e = app.elements[i];
+        uint32_t a = (uint32_t)e.n1, b = (uint32_t)e.n2;
+        if (a > b) std::swap(a, b);
+        auto ins = kept.emplace(((uint64_t)a << 32) | b, w);
+        size_t j = ins.first->second;
+        if (!ins.second && (isPiece[i] || isPiece[j])) {
+            // Postojeci stap ima prednost pred delom podele
+            Element drop = e;
+            if (isPiece[j] && !isPiece[i]) {
+                drop = app.elements[j];
+                app.elements[j] = e;
+                isPiece[j]      = 0;
+                markDirty(ARR_ELEMENTS, j, j + 1);
+            }
+            if (drop.section != app.elements[j].section) {
+                if (nConflict < 10)
+                    printf("  [INFO] Preklopljeni deo %s-%s: zadrzana sekcija %d, izbacena %d\n",
+                           nodeLabel(a).c_str(), nodeLabel(b).c_str(),
+                           app.elements[j].section, drop.section);
+                nConflict++;
+            }
+            if (w == i) markDirty(ARR_ELEMENTS, w);   // prvo izbacivanje pomera ostatak
+            continue;
+        }
+        isPiece[w] = isPiece[i];
+        app.elements[w++] = e;
+    }
+    app.elements.resize(w);
+    if (nConflict > 10)
+        printf("  [INFO] ... ukupno preklopljenih delova sa razlicitim sekcijama: %d\n", nConflict);
+    if (nConflict > 0)
+        printf("  [INFO] Proverite sekcije tih stapova (E: izbor stapova, Enter: unos)\n");
+
+    printf("  [OK] Podela stapova: %d novih cvorova, stapova %d → %d\n\n",
+           (int)app.nodes.size() - nNodes0, nE0, (int)app.elements.size());
+    return (int)app.elements.size() - nE0;
+}
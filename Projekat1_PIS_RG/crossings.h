@@ -0,0 +1,37 @@
+#ifndef CROSSINGS_H
+#define CROSSINGS_H
+
+#include <vector>
+
+// ─────────────────────────────────────────────
+//  Preseci i preklapanja stapova
+// ─────────────────────────────────────────────
+enum CrossKind {
+    CROSS_PROPER,    // unutrasnjosti stapova se seku (bez zajednickog cvora)
+    CROSS_TOUCH,     // cvor lezi na stapu a nije njegov kraj / dva razlicita cvora se poklapaju
+    CROSS_OVERLAP    // kolinearni stapovi se preklapaju (node = kraj stapa b unutar stapa a)
+};
+
+struct Crossing {
+    int       a, b;    // indeksi stapova; kod TOUCH / OVERLAP tacka je unutar a
+    CrossKind kind;
+    int       node;    // postojeci cvor u tacki, -1 = nema (PROPER, poklopljeni cvorovi)
+    float     x, y;    // tacka (za prikaz i novi cvor)
+};
+
+// Bentley–Ottmann nad celobrojnim koordinatama: cvorovi se zaokruzuju na
+// mrezu od najvise 2^24 polja duz vece dimenzije modela (korak je stepen
+// dvojke), a svi testovi (orijentacija, redosled dogadjaja u racionalnim
+// tackama preseka) su tacni u 128 bita.
+// O((n + k) log n) za n stapova i k preseka. Stapovi koji se sastaju u
+// zajednickom cvoru nisu presek.
+void findCrossings(std::vector<Crossing>& out);
+
+// Deli stapove: u presecima nastaju novi cvorovi, stap na kome lezi cvor
+// se deli u tom cvoru, a preklopljeni delovi ostaju samo jednom (postojeci
+// stap ima prednost, razlicite sekcije se prijavljuju). Duplikati koji su
+// postojali i pre podele se ne diraju. Novi stapovi zadrzavaju sekciju. Indeksi stapova se menjaju. Vraca broj
+// stapova koji su dodati (negativan ako ih je vise uklonjeno).
+int  splitCrossings(const std::vector<Crossing>& found);
+
+#endif
@@ -0,0 +1,295 @@
+#include "dynamics.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+
+static std::string nodeLabel(int i)
+{
+    std::string s;
+    do {
+        s = (char)('A' + (i % 26)) + s;
+        i = i / 26 - 1;
+    } while (i >= 0);
+    return s;
+}
+
+// ─────────────────────────────────────────────
+//  Podaci stapova u SoA obliku, grupisani po bojama
+// ─────────────────────────────────────────────
+// Stapovi iste boje nemaju zajednicki cvor, pa se njihove sile mogu
+// dodavati u cvorove paralelno i bez zakljucavanja. Unutar boje petlja
+// je cist SoA pristup (omp simd).
+struct MemberData {
+    std::vector<int>    n1, n2;
+    std::vector<double> cx, cy;   // jedinicni vektor stapa
+    std::vector<double> k;        // E*A/L
+    std::vector<int>    colourStart;
+};
+
+// Pohlepno bojenje ivica: najmanja boja slobodna u oba cvora (<= 2*deg - 1)
+static std::vector<int> colourMembers(int& nColours)
+{
+    const int nN = (int)app.nodes.size();
+    const int nE = (int)app.elements.size();
+    std::vector<std::vector<uint64_t>> used(nN);   // bit-maske zauzetih boja
+    std::vector<int> colour(nE);
+    nColours = 0;
+
+    auto isUsed = [&](int n, int c) {
+        size_t w = c / 64;
+        return w < used[n].size() && ((used[n][w] >> (c % 64)) & 1);
+    };
+    auto mark = [&](int n, int c) {
+        size_t w = c / 64;
+        if (used[n].size() <= w) used[n].resize(w + 1, 0);
+        used[n][w] |= (uint64_t)1 << (c % 64);
+    };
+
+    for (int i = 0; i < nE; i++) {
+        int a = app.elements[i].n1, b = app.elements[i].n2;
+        int c = 0;
+        while (isUsed(a, c) || isUsed(b, c)) c++;
+        mark(a, c);
+        mark(b, c);
+        colour[i] = c;
+        if (c + 1 > nColours) nColours = c + 1;
+    }
+    return colour;
+}
+
+static void buildMembers(MemberData& md)
+{
+    const int nE = (int)app.elements.size();
+    int nColours;
+    std::vector<int> colour = colourMembers(nColours);
+
+    // Prebrojavanje po bojama → stapovi svake boje su susedni u nizovima
+    md.colourStart.assign(nColours + 1, 0);
+    for (int i = 0; i < nE; i++) md.colourStart[colour[i] + 1]++;
+    for (int c = 0; c < nColours; c++) md.colourStart[c + 1] += md.colourStart[c];
+
+    md.n1.resize(nE); md.n2.resize(nE);
+    md.cx.resize(nE); md.cy.resize(nE); md.k.resize(nE);
+    std::vector<int> pos(md.colourStart.begin(), md.colourStart.end() - 1);
+    for (int i = 0; i < nE; i++) {
+        const Element& e = app.elements[i];
+        double dx = app.nodes[e.n2].x - app.nodes[e.n1].x;
+        double dy = app.nodes[e.n2].y - app.nodes[e.n1].y;
+        double L  = sqrt(dx*dx + dy*dy);
+        int    j  = pos[colour[i]]++;
+        md.n1[j] = e.n1;
+        md.n2[j] = e.n2;
+        md.cx[j] = dx / L;
+        md.cy[j] = dy / L;
+        md.k[j]  = (double)sectionOf(e).E * sectionOf(e).A / L;
+    }
+}
+
+// ─────────────────────────────────────────────
+//  Unutrasnje sile  r = K u  (po bojama)
+// ─────────────────────────────────────────────
+static void internalForces(const MemberData& md,
+                           const double* ux, const double* uy,
+                           double* rx, double* ry, int nN)
+{
+    for (int i = 0; i < nN; i++) { rx[i] = 0.0; ry[i] = 0.0; }
+
+    const int*    n1 = md.n1.data();
+    const int*    n2 = md.n2.data();
+    const double* cx = md.cx.data();
+    const double* cy = md.cy.data();
+    const double* k  = md.k.data();
+    const int nColours = (int)md.colourStart.size() - 1;
+
+    for (int c = 0; c < nColours; c++) {
+        const int begin = md.colourStart[c], end = md.colourStart[c + 1];
+        #pragma omp parallel for simd schedule(static) if(end - begin > 20000)
+        for (int j = begin; j < end; j++) {
+            const int    a  = n1[j], b = n2[j];
+            const double N  = k[j] * ((ux[b] - ux[a]) * cx[j] + (uy[b] - uy[a]) * cy[j]);
+            const double fx = N * cx[j], fy = N * cy[j];
+            rx[a] -= fx; ry[a] -= fy;
+            rx[b] += fx; ry[b] += fy;
+        }
+    }
+}
+
+// Vrednost deo-po-deo linearne istorije; `cursor` pamti poslednji interval
+// (vreme samo raste, pa je pretraga amortizovano O(1))
+static double historyValue(const TimeLoad& tl, double t, size_t& cursor)
+{
+    const size_t n = tl.t.size();
+    if (n == 0) return 0.0;
+    if (t <= tl.t[0]) return tl.F[0];
+    while (cursor + 1 < n && tl.t[cursor + 1] < t) cursor++;
+    if (cursor + 1 >= n) return tl.F[n - 1];
+    double t0 = tl.t[cursor], t1 = tl.t[cursor + 1];
+    double w  = (t1 > t0) ? (t - t0) / (t1 - t0) : 1.0;
+    return tl.F[cursor] + w * (tl.F[cursor + 1] - tl.F[cursor]);
+}
+
+// ─────────────────────────────────────────────
+//  runDynamics
+// ─────────────────────────────────────────────
+bool runDynamics(const DynamicsParams& p)
+{
+    if (!validateModel()) {
+        printf("  [GRESKA] Dinamicka analiza prekinuta — model nije ispravan\n\n");
+        return false;
+    }
+
+    const int nN = (int)app.nodes.size();
+    const int nE = (int)app.elements.size();
+
+    MemberData md;
+    buildMembers(md);
+
+    // ── Koncentrisane mase i kriticni korak ──────────────────
+    std::vector<double> mass(nN, 0.0);
+    double dtCrit = 1e30;
+    for (int i = 0; i < nE; i++) {
+        const Element& e = app.elements[i];
+        const Section& s = sectionOf(e);
+        double dx = app.nodes[e.n2].x - app.nodes[e.n1].x;
+        double dy = app.nodes[e.n2].y - app.nodes[e.n1].y;
+        double L  = sqrt(dx*dx + dy*dy);
+        double m  = (double)s.rho * s.A * L;
+        mass[e.n1] += 0.5 * m;
+        mass[e.n2] += 0.5 * m;
+        // Stap sa dve polovine mase: omega_max = 2 c / L
+        if (s.rho > 0.0f) {
+            double c = sqrt((double)s.E / s.rho);
+            if (L / c < dtCrit) dtCrit = L / c;
+        }
+    }
+    for (int i = 0; i < nN; i++)
+        if (mass[i] <= 0.0) {
+            printf("  [GRESKA] Cvor %s nema masu (gustina stapova je 0)\n\n",
+                   nodeLabel(i).c_str());
+            return false;
+        }
+
+    double dt = (p.dt > 0.0) ? p.dt : 0.9 * dtCrit;
+    if (dt > dtCrit)
+        printf("  [UPOZORENJE] dt = %.3e s > kriticni %.3e s — resenje ce divergirati\n",
+               dt, dtCrit);
+    const long nSteps = (long)ceil(p.tEnd / dt);
+    const int  every  = (p.outputEvery > 0) ? p.outputEvery : 1;
+
+    // ── Veze oslonaca po cvoru: 0 = slobodan, 1 = pokretni, 2 = nepokretni ─
+    std::vector<char>   fixMode(nN, 0);
+    std::vector<double> fnx(nN, 0.0), fny(nN, 0.0);   // pravac reakcije pokretnog
+    for (const Support& s : app.supports) {
+        int n = s.node;
+        if (s.type == FIXED || fixMode[n] == 2) { fixMode[n] = 2; continue; }
+        double nx = -sin(s.angle), ny = cos(s.angle);
+        if (fixMode[n] == 1 && fabs(nx*fny[n] - ny*fnx[n]) > 1e-6) {
+            fixMode[n] = 2;   // dva neparalelna pokretna = nepokretni
+            continue;
+        }
+        fixMode[n] = 1; fnx[n] = nx; fny[n] = ny;
+    }
+    auto constrain = [&](double* x, double* y) {
+        #pragma omp parallel for schedule(static) if(nN > 20000)
+        for (int i = 0; i < nN; i++) {
+            if (fixMode[i] == 2) { x[i] = 0.0; y[i] = 0.0; }
+            else if (fixMode[i] == 1) {
+                double d = x[i]*fnx[i] + y[i]*fny[i];
+                x[i] -= d * fnx[i];
+                y[i] -= d * fny[i];
+            }
+        }
+    };
+
+    // ── Konstantni deo opterecenja ───────────────────────────
+    std::vector<double> fx0(nN, 0.0), fy0(nN, 0.0);
+    for (const Force& f : app.forces) {
+        fx0[f.node] += f.magnitude * cos(f.angle);
+        fy0[f.node] += f.magnitude * sin(f.angle);
+    }
+    std::vector<size_t> cursor(app.timeLoads.size(), 0);
+
+    // ── Izlazni fajl ─────────────────────────────────────────
+    FILE* out = fopen(p.outPath, "wb");
+    if (!out) {
+        printf("  [GRESKA] Nije moguce otvoriti %s za pisanje!\n\n", p.outPath);
+        return false;
+    }
+    int32_t header[2] = { nN, 0 };
+    fwrite("MKED", 1, 4, out);
+    fwrite(header, sizeof(int32_t), 2, out);
+
+    std::vector<double> ux(nN, 0.0), uy(nN, 0.0);
+    std::vector<double> vx(nN, 0.0), vy(nN, 0.0);   // brzina u t - dt/2
+    std::vector<double> rx(nN), ry(nN);
+    std::vector<double> fx(nN), fy(nN);
+    std::vector<float>  frame(2 * (size_t)nN);
+    int32_t nFrames = 0;
+    double  maxU    = 0.0;
+
+    printf("  Dinamicka analiza: %d cvorova, %d stapova, %d boja, dt = %.3e s, %ld koraka\n",
+           nN, nE, (int)md.colourStart.size() - 1, dt, nSteps);
+
+    const double c1 = 1.0 - 0.5 * p.damping * dt;
+    const double c2 = 1.0 / (1.0 + 0.5 * p.damping * dt);
+
+    for (long step = 0; step <= nSteps; step++) {
+        const double t = step * dt;
+
+        // Snimak pre koraka → u(t)
+        if (step % every == 0) {
+            for (int i = 0; i < nN; i++) {
+                frame[2*i]     = (float)ux[i];
+                frame[2*i + 1] = (float)uy[i];
+                double u = sqrt(ux[i]*ux[i] + uy[i]*uy[i]);
+                if (u > maxU) maxU = u;
+            }
+            fwrite(&t, sizeof(double), 1, out);
+            fwrite(frame.data(), sizeof(float), frame.size(), out);
+            nFrames++;
+
+            if (!std::isfinite(maxU)) {
+                printf("  [GRESKA] Resenje je divergiralo u t = %.3e s\n", t);
+                break;
+            }
+        }
+        if (step == nSteps) break;
+
+        // Spoljasnje sile u t
+        for (int i = 0; i < nN; i++) { fx[i] = fx0[i]; fy[i] = fy0[i]; }
+        for (size_t l = 0; l < app.timeLoads.size(); l++) {
+            const TimeLoad& tl = app.timeLoads[l];
+            double F = historyValue(tl, t, cursor[l]);
+            fx[tl.node] += F * cos(tl.angle);
+            fy[tl.node] += F * sin(tl.angle);
+        }
+
+        internalForces(md, ux.data(), uy.data(), rx.data(), ry.data(), nN);
+
+        // v(t + dt/2) i u(t + dt); prvi korak polazi od v(0), pa je pola koraka
+        const double h = (step == 0) ? 0.5 * dt : dt;
+        #pragma omp parallel for simd schedule(static) if(nN > 20000)
+        for (int i = 0; i < nN; i++) {
+            double inv = h / mass[i];
+            vx[i] = c2 * (c1 * vx[i] + inv * (fx[i] - rx[i]));
+            vy[i] = c2 * (c1 * vy[i] + inv * (fy[i] - ry[i]));
+        }
+        constrain(vx.data(), vy.data());
+        #pragma omp parallel for simd schedule(static) if(nN > 20000)
+        for (int i = 0; i < nN; i++) {
+            ux[i] += dt * vx[i];
+            uy[i] += dt * vy[i];
+        }
+    }
+
+    header[1] = nFrames;
+    fseek(out, 4, SEEK_SET);
+    fwrite(header, sizeof(int32_t), 2, out);
+    fclose(out);
+
+    printf("  [OK] %d snimaka upisano u %s, max |u| = %.6e m\n\n", nFrames, p.outPath, maxU);
+    return true;
+}
@@ -0,0 +1,24 @@
+#ifndef DYNAMICS_H
+#define DYNAMICS_H
+
+// ─────────────────────────────────────────────
+//  Eksplicitna dinamicka analiza (centralne razlike)
+// ─────────────────────────────────────────────
+struct DynamicsParams {
+    double tEnd        = 1.0;    // s
+    double dt          = 0.0;    // s, 0 = automatski (0.9 * kriticni korak)
+    int    outputEvery = 100;    // snimak pomeranja svakih N koraka
+    double damping     = 0.0;    // 1/s, prigusenje proporcionalno masi
+    const char* outPath = "MKE-2D.dyn";
+};
+
+// Masa je koncentrisana u cvorovima (rho * A * L / 2 po kraju stapa).
+// Opterecenje: staticke sile iz app.forces deluju konstantno od t = 0,
+// a app.timeLoads po svojoj vremenskoj istoriji.
+//
+// Snimci se odmah upisuju u outPath (binarno):
+//   "MKED", int32 brojCvorova, int32 brojSnimaka (upisuje se na kraju),
+//   zatim za svaki snimak: float64 t, float32 [ux, uy] * brojCvorova
+bool runDynamics(const DynamicsParams& p);
+
+#endif
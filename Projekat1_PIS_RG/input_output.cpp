@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "autosave.h"
 #include <cstdio>
 #include <cmath>
 #include <string>
@@ -13,42 +14,53 @@ static std::string nodeLabel(int i)
     return s;
 }
 
-void saveToFile()
+// ─────────────────────────────────────────────
+//  Upis modela — isti kod za `app` i za snimak
+//  (oba imaju nodes/sections/elements/supports/forces sa size() i [])
+// ─────────────────────────────────────────────
+template <typename Model>
+static void writeModel(FILE* f, const Model& m)
 {
-    FILE* f = fopen("MKE-2D.ulz", "w");
-    if (!f) {
-        printf("  [GRESKA] Nije moguce otvoriti MKE-2D.ulz za pisanje!\n");
-        return;
-    }
-
     // ── Cvorovi ───────────────────────────────────────────────
-    fprintf(f, "CVOROVI %d\n", (int)app.nodes.size());
+    fprintf(f, "CVOROVI %d\n", (int)m.nodes.size());
     fprintf(f, "# naziv   x [m]       y [m]\n");
-    for (int i = 0; i < (int)app.nodes.size(); i++) {
+    for (int i = 0; i < (int)m.nodes.size(); i++) {
         fprintf(f, "%s        %.6f [m]   %.6f [m]\n",
                 nodeLabel(i).c_str(),
-                (double)app.nodes[i].x,
-                (double)app.nodes[i].y);
+                (double)m.nodes[i].x,
+                (double)m.nodes[i].y);
+    }
+
+    // ── Sekcije ───────────────────────────────────────────────
+    fprintf(f, "\nSEKCIJE %d\n", (int)m.sections.size());
+    fprintf(f, "# br   E [Pa]          A [m^2]          rho [kg/m^3]\n");
+    for (int i = 0; i < (int)m.sections.size(); i++) {
+        const Section& sc = m.sections[i];
+        fprintf(f, "%d      %.6e [Pa]   %.6e [m^2]   %.2f [kg/m^3]\n",
+                i, (double)sc.E, (double)sc.A, (double)sc.rho);
     }
 
-    // ── Stapovi ───────────────────────────────────────────────
-    fprintf(f, "\nSTAPOVI %d\n", (int)app.elements.size());
-    fprintf(f, "# br   n1  n2   E [Pa]          A [m^2]\n");
-    for (int i = 0; i < (int)app.elements.size(); i++) {
-        const Element& e = app.elements[i];
-        fprintf(f, "%d      %s   %s   %.6e [Pa]   %.6e [m^2]\n",
+    // ── Stapovi (E, A, rho ostaju u redu zbog postojecih citaca) ─
+    fprintf(f, "\nSTAPOVI %d\n", (int)m.elements.size());
+    fprintf(f, "# br   n1  n2   E [Pa]          A [m^2]          rho [kg/m^3]     sekcija\n");
+    for (int i = 0; i < (int)m.elements.size(); i++) {
+        const Element& e  = m.elements[i];
+        const Section& sc = m.sections[e.section];
+        fprintf(f, "%d      %s   %s   %.6e [Pa]   %.6e [m^2]   %.2f [kg/m^3]   %d\n",
                 i + 1,
                 nodeLabel(e.n1).c_str(),
                 nodeLabel(e.n2).c_str(),
-                (double)e.E,
-                (double)e.A);
+                (double)sc.E,
+                (double)sc.A,
+                (double)sc.rho,
+                (int)e.section);
     }
 
     // ── Oslonci ───────────────────────────────────────────────
-    fprintf(f, "\nOSLONCI %d\n", (int)app.supports.size());
+    fprintf(f, "\nOSLONCI %d\n", (int)m.supports.size());
     fprintf(f, "# cvor   tip           ugao [deg]\n");
-    for (int i = 0; i < (int)app.supports.size(); i++) {
-        const Support& s = app.supports[i];
+    for (int i = 0; i < (int)m.supports.size(); i++) {
+        const Support& s = m.supports[i];
         float angleDeg = s.angle * 180.0f / (float)M_PI;
         fprintf(f, "%s       %-12s  %.2f [deg]\n",
                 nodeLabel(s.node).c_str(),
@@ -57,10 +69,10 @@ void saveToFile()
     }
 
     // ── Sile ──────────────────────────────────────────────────
-    fprintf(f, "\nSILE %d\n", (int)app.forces.size());
+    fprintf(f, "\nSILE %d\n", (int)m.forces.size());
     fprintf(f, "# cvor   Fx [N]          Fy [N]          |F| [N]       ugao [deg]\n");
-    for (int i = 0; i < (int)app.forces.size(); i++) {
-        const Force& fc = app.forces[i];
+    for (int i = 0; i < (int)m.forces.size(); i++) {
+        const Force& fc = m.forces[i];
         float Fx  = fc.magnitude * cosf(fc.angle);
         float Fy  = fc.magnitude * sinf(fc.angle);
         float deg = fc.angle * 180.0f / (float)M_PI;
@@ -70,6 +82,52 @@ void saveToFile()
                 (double)fc.magnitude, (double)deg);
     }
 
-    fclose(f);
+    // ── Sile sa vremenskom istorijom (samo ako postoje) ───────
+    if (m.timeLoads.size() == 0) return;
+    fprintf(f, "\nDINAMICKE_SILE %d\n", (int)m.timeLoads.size());
+    fprintf(f, "# cvor   ugao [deg]   broj_tacaka   t [s]  F [N] ...\n");
+    for (int i = 0; i < (int)m.timeLoads.size(); i++) {
+        const TimeLoad& tl = m.timeLoads[i];
+        fprintf(f, "%s       %.2f [deg]   %d  ",
+                nodeLabel(tl.node).c_str(),
+                (double)(tl.angle * 180.0f / (float)M_PI),
+                (int)tl.t.size());
+        for (size_t k = 0; k < tl.t.size(); k++)
+            fprintf(f, "  %.6f %.6f", (double)tl.t[k], (double)tl.F[k]);
+        fprintf(f, "\n");
+    }
+}
+
+// Upis u privremeni fajl pa rename — prekid usred upisa ne kvari
+// prethodnu verziju fajla.
+template <typename Model>
+static bool writeModelAtomic(const Model& m, const char* path)
+{
+    std::string tmp = std::string(path) + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (!f) return false;
+
+    writeModel(f, m);
+
+    bool ok = (fflush(f) == 0) && !ferror(f);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || rename(tmp.c_str(), path) != 0) {
+        remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool saveSnapshot(const ModelSnapshot& snap, const char* path)
+{
+    return writeModelAtomic(snap, path);
+}
+
+void saveToFile()
+{
+    if (!writeModelAtomic(app, "MKE-2D.ulz")) {
+        printf("  [GRESKA] Nije moguce upisati MKE-2D.ulz!\n");
+        return;
+    }
     printf("\n  [OK] Sacuvano u MKE-2D.ulz\n\n");
 }
@@ -1,7 +1,21 @@
 #include "window.h"
+#include "offscreen.h"
+#include "replay.h"
+#include <cstring>
 
 int main(int argc, char** argv)
 {
+    // Batch renderovanje bez prozora (bez X servera)
+    if (argc >= 2 && strncmp(argv[1], "--render", 8) == 0)
+        return runRenderCommand(argc, argv);
+
+    // Ponavljanje snimljenog ulaza (sa prozorom ili --headless)
+    if (argc >= 2 && strcmp(argv[1], "--replay") == 0)
+        return runReplayCommand(argc, argv);
+
+    if (argc >= 3 && strcmp(argv[1], "--record") == 0 && !startRecording(argv[2]))
+        return 1;
+
     initWindow(argc, argv);
     glutMainLoop();
     return 0;
@@ -0,0 +1,505 @@
+#include "modal.h"
+#include "solver.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+static std::string nodeLabel(int i)
+{
+    std::string s;
+    do {
+        s = (char)('A' + (i % 26)) + s;
+        i = i / 26 - 1;
+    } while (i >= 0);
+    return s;
+}
+
+static ModeShapes shapes;
+
+const ModeShapes& lastModeShapes()
+{
+    return shapes;
+}
+
+// ─────────────────────────────────────────────
+//  Operatori (stap po stap, bez sklapanja matrica)
+// ─────────────────────────────────────────────
+// Vektori su u redosledu cvorova iz app: [ux0, uy0, ux1, uy1, ...]
+struct EigenOperators {
+    const TrussSymbolic* sym;
+    const SkylineMatrix* K;          // faktorisana (K = U^T U)
+    EigenKind            kind;
+    MassType             mass;
+    std::vector<double>  EA;         // po stapu
+    std::vector<double>  m;          // rho * A * L po stapu
+    std::vector<double>  N;          // aksijalne sile staticnog proracuna
+    std::vector<double>  lumped;     // koncentrisana masa po cvoru
+    double               pen = 0.0;  // kaznena krutost oslonaca (kao u solveNumeric)
+    mutable std::vector<double> tmp;
+};
+
+static void massMul(const EigenOperators& op, const double* x, double* y)
+{
+    const TrussSymbolic& s = *op.sym;
+    if (op.mass == MASS_LUMPED) {
+        for (int i = 0; i < s.nNodes; i++) {
+            y[2*i]     = op.lumped[i] * x[2*i];
+            y[2*i + 1] = op.lumped[i] * x[2*i + 1];
+        }
+        return;
+    }
+    std::fill(y, y + 2 * (size_t)s.nNodes, 0.0);
+    for (int i = 0; i < s.nElems; i++) {
+        const int    a = s.n1[i], b = s.n2[i];
+        const double w = op.m[i] / 6.0;
+        y[2*a]     += w * (2.0 * x[2*a]     + x[2*b]);
+        y[2*a + 1] += w * (2.0 * x[2*a + 1] + x[2*b + 1]);
+        y[2*b]     += w * (x[2*a]     + 2.0 * x[2*b]);
+        y[2*b + 1] += w * (x[2*a + 1] + 2.0 * x[2*b + 1]);
+    }
+}
+
+// K x, ukljucujuci kaznene veze oslonaca
+static void stiffMul(const EigenOperators& op, const double* x, double* y)
+{
+    const TrussSymbolic& s = *op.sym;
+    std::fill(y, y + 2 * (size_t)s.nNodes, 0.0);
+    for (int i = 0; i < s.nElems; i++) {
+        const int    a = s.n1[i], b = s.n2[i];
+        const double d = op.EA[i] / s.L[i] *
+                         ((x[2*b] - x[2*a]) * s.cx[i] + (x[2*b + 1] - x[2*a + 1]) * s.cy[i]);
+        y[2*a] -= d * s.cx[i]; y[2*a + 1] -= d * s.cy[i];
+        y[2*b] += d * s.cx[i]; y[2*b + 1] += d * s.cy[i];
+    }
+    for (size_t l = 0; l < s.supNode.size(); l++) {
+        const int    n = s.supNode[l];
+        const double d = op.pen * (s.supNx[l] * x[2*n] + s.supNy[l] * x[2*n + 1]);
+        y[2*n]     += d * s.supNx[l];
+        y[2*n + 1] += d * s.supNy[l];
+    }
+}
+
+// -K_G x: pritisak (N < 0) daje pozitivan doprinos
+static void negGeomMul(const EigenOperators& op, const double* x, double* y)
+{
+    const TrussSymbolic& s = *op.sym;
+    std::fill(y, y + 2 * (size_t)s.nNodes, 0.0);
+    for (int i = 0; i < s.nElems; i++) {
+        const int    a  = s.n1[i], b = s.n2[i];
+        const double nx = -s.cy[i], ny = s.cx[i];
+        const double d  = -op.N[i] / s.L[i] *
+                          ((x[2*b] - x[2*a]) * nx + (x[2*b + 1] - x[2*a + 1]) * ny);
+        y[2*a] -= d * nx; y[2*a + 1] -= d * ny;
+        y[2*b] += d * nx; y[2*b + 1] += d * ny;
+    }
+}
+
+// B iz skalarnog proizvoda <x, y>_B = x^T B y (M za modalnu, K za izvijanje)
+static void innerMul(const EigenOperators& op, const double* x, double* y)
+{
+    if (op.kind == EIGEN_MODAL) massMul(op, x, y);
+    else                        stiffMul(op, x, y);
+}
+
+// y = K^-1 A x  (A = M, odnosno -K_G)
+static void applyOp(const EigenOperators& op, const double* x, double* y)
+{
+    const TrussSymbolic& s = *op.sym;
+    if (op.kind == EIGEN_MODAL) massMul(op, x, y);
+    else                        negGeomMul(op, x, y);
+    op.tmp.resize(s.nDof);
+    for (int i = 0; i < s.nNodes; i++) {
+        op.tmp[s.dofOfNode[i]]     = y[2*i];
+        op.tmp[s.dofOfNode[i] + 1] = y[2*i + 1];
+    }
+    op.K->solve(op.tmp.data());
+    for (int i = 0; i < s.nNodes; i++) {
+        y[2*i]     = op.tmp[s.dofOfNode[i]];
+        y[2*i + 1] = op.tmp[s.dofOfNode[i] + 1];
+    }
+}
+
+// ─────────────────────────────────────────────
+//  Mala gusta simetricna matrica (Jacobi)
+// ─────────────────────────────────────────────
+// A (n x n) se unistava; theta opadajuce, S[i * n + q] = i-ta komponenta q-tog vektora
+static void denseEigen(int n, std::vector<double>& A,
+                       std::vector<double>& theta, std::vector<double>& S)
+{
+    std::vector<double> Q((size_t)n * n, 0.0);
+    for (int i = 0; i < n; i++) Q[(size_t)i * n + i] = 1.0;
+
+    for (int sweep = 0; sweep < 100; sweep++) {
+        double off = 0.0, diag = 0.0;
+        for (int i = 0; i < n; i++) {
+            diag += A[(size_t)i * n + i] * A[(size_t)i * n + i];
+            for (int j = i + 1; j < n; j++) off += A[(size_t)i * n + j] * A[(size_t)i * n + j];
+        }
+        if (off <= 1e-30 * diag || off == 0.0) break;
+
+        for (int p = 0; p < n; p++)
+            for (int q = p + 1; q < n; q++) {
+                const double apq = A[(size_t)p * n + q];
+                if (apq == 0.0) continue;
+                const double app = A[(size_t)p * n + p], aqq = A[(size_t)q * n + q];
+                const double tau = (aqq - app) / (2.0 * apq);
+                const double t   = (tau >= 0.0 ? 1.0 : -1.0) / (fabs(tau) + sqrt(1.0 + tau * tau));
+                const double c   = 1.0 / sqrt(1.0 + t * t), s = t * c;
+                for (int k = 0; k < n; k++) {
+                    const double akp = A[(size_t)k * n + p], akq = A[(size_t)k * n + q];
+                    A[(size_t)k * n + p] = c * akp - s * akq;
+                    A[(size_t)k * n + q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; k++) {
+                    const double apk = A[(size_t)p * n + k], aqk = A[(size_t)q * n + k];
+                    A[(size_t)p * n + k] = c * apk - s * aqk;
+                    A[(size_t)q * n + k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; k++) {
+                    const double qkp = Q[(size_t)k * n + p], qkq = Q[(size_t)k * n + q];
+                    Q[(size_t)k * n + p] = c * qkp - s * qkq;
+                    Q[(size_t)k * n + q] = s * qkp + c * qkq;
+                }
+            }
+    }
+
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return A[(size_t)a * n + a] > A[(size_t)b * n + b];
+    });
+    theta.resize(n);
+    S.resize((size_t)n * n);
+    for (int q = 0; q < n; q++) {
+        theta[q] = A[(size_t)order[q] * n + order[q]];
+        for (int i = 0; i < n; i++) S[(size_t)i * n + q] = Q[(size_t)i * n + order[q]];
+    }
+}
+
+// ─────────────────────────────────────────────
+//  Vektorske operacije nad bazom (paralelno po DOF)
+// ─────────────────────────────────────────────
+static double dot(const double* x, const double* y, long n)
+{
+    double s = 0.0;
+    #pragma omp parallel for reduction(+:s) schedule(static) if(n > 20000)
+    for (long d = 0; d < n; d++) s += x[d] * y[d];
+    return s;
+}
+
+// Klasicni Gram–Schmidt u B-skalarnom proizvodu prema V[0 .. cols);
+// drugi prolaz samo ako je norma pala vise od 1/sqrt(2) (DGKS).
+// Koeficijenti se dodaju u h, a Bw na izlazu odgovara novom w.
+static void orthogonalize(const EigenOperators& op, const std::vector<double>& V,
+                          int cols, long n, double* w, double* Bw, double* h)
+{
+    std::vector<double> c(cols);
+    innerMul(op, w, Bw);
+    double norm = dot(w, Bw, n);
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < cols; i++) c[i] = dot(&V[(size_t)i * n], Bw, n);
+        // Po kolonama (uzastopna memorija), ne po redovima
+        for (int i = 0; i < cols; i++) {
+            const double* v = &V[(size_t)i * n];
+            #pragma omp parallel for simd schedule(static) if(n > 20000)
+            for (long d = 0; d < n; d++) w[d] -= c[i] * v[d];
+        }
+        for (int i = 0; i < cols; i++) h[i] += c[i];
+        innerMul(op, w, Bw);
+        double after = dot(w, Bw, n);
+        if (after > 0.5 * norm) break;
+        norm = after;
+    }
+}
+
+// Deterministicki pocetni vektor (isti model → isti rezultat)
+static void startVector(double* v, long n, uint64_t seed)
+{
+    for (long d = 0; d < n; d++) {
+        uint64_t x = seed + (uint64_t)d * 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        x ^= x >> 31;
+        v[d] = (double)(x >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+    }
+}
+
+// ─────────────────────────────────────────────
+//  Krylov–Schur (Lanczos sa debelim restartom)
+// ─────────────────────────────────────────────
+// Trazi k najvecih theta operatora (simetricnog u B-skalarnom proizvodu).
+// Vraca broj konvergiranih parova; phi[q * n ..] su B-ortonormirani.
+static int lanczos(const EigenOperators& op, long n, int k, double tol, int maxRestarts,
+                   std::vector<double>& thetaOut, std::vector<double>& phi,
+                   int& restartsUsed, long& opCount)
+{
+    const int m = (int)std::min<long>(n, std::max(2 * k + 10, 20));
+    std::vector<double> V((size_t)(m + 1) * n);
+    std::vector<double> T((size_t)m * m, 0.0);
+    std::vector<double> w(n), Bw(n), h(m + 1);
+    std::vector<double> theta, S;
+
+    uint64_t seed = 0x5EED;
+    auto freshVector = [&](int j) -> bool {
+        // Novi pravac B-ortogonalan na V[0 .. j); false ako je prostor iscrpljen
+        for (int attempt = 0; attempt < 3; attempt++) {
+            double* v = &V[(size_t)j * n];
+            startVector(v, n, seed++);
+            std::fill(h.begin(), h.end(), 0.0);
+            innerMul(op, v, Bw.data());
+            double norm0 = sqrt(std::max(dot(v, Bw.data(), n), 0.0));
+            if (j > 0) orthogonalize(op, V, j, n, v, Bw.data(), h.data());
+            double norm = sqrt(std::max(dot(v, Bw.data(), n), 0.0));
+            if (norm > 1e-8 * norm0 && norm > 0.0) {
+                for (long d = 0; d < n; d++) v[d] /= norm;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (!freshVector(0)) return 0;
+
+    int    kept = 0;
+    int    mEff = m;
+    double beta = 0.0;
+    opCount = 0;
+    for (restartsUsed = 0; restartsUsed <= maxRestarts; restartsUsed++) {
+        mEff = m;
+        for (int j = kept; j < m; j++) {
+            applyOp(op, &V[(size_t)j * n], w.data());
+            opCount++;
+            std::fill(h.begin(), h.end(), 0.0);
+            orthogonalize(op, V, j + 1, n, w.data(), Bw.data(), h.data());
+            for (int i = 0; i <= j; i++)
+                T[(size_t)i * m + j] = T[(size_t)j * m + i] = h[i];
+            double hNorm = 0.0;
+            for (int i = 0; i <= j; i++) hNorm = std::max(hNorm, fabs(h[i]));
+
+            beta = sqrt(std::max(dot(w.data(), Bw.data(), n), 0.0));
+            double* next = &V[(size_t)(j + 1) * n];
+            if (beta > 1e-12 * hNorm) {
+                for (long d = 0; d < n; d++) next[d] = w[d] / beta;
+            } else {
+                // Invarijantni potprostor: nastavlja se novim pravcem (veza 0)
+                beta = 0.0;
+                if (j + 1 >= m) break;
+                if (!freshVector(j + 1)) { mEff = j + 1; break; }
+            }
+            if (j + 1 < m)
+                T[(size_t)(j + 1) * m + j] = T[(size_t)j * m + (j + 1)] = beta;
+        }
+
+        // Ritz-ove vrednosti projekcije
+        std::vector<double> A((size_t)mEff * mEff);
+        for (int i = 0; i < mEff; i++)
+            for (int j = 0; j < mEff; j++) A[(size_t)i * mEff + j] = T[(size_t)i * m + j];
+        denseEigen(mEff, A, theta, S);
+
+        const int kk = std::min(k, mEff);
+        int conv = 0;
+        while (conv < kk &&
+               fabs(beta * S[(size_t)(mEff - 1) * mEff + conv]) <= tol * std::max(fabs(theta[conv]), 1e-300))
+            conv++;
+
+        const int p = std::min(k + (m - k) / 2, m - 1);
+        bool done = (conv == kk) || mEff < m || restartsUsed == maxRestarts || p <= 0;
+        const int keep = done ? kk : p;
+
+        // V <- V S[:, 0 .. keep), u blokovima redova (blok svih kolona staje u kes)
+        const long ROWS = 64;
+        #pragma omp parallel for schedule(static) if(n > 20000)
+        for (long d0 = 0; d0 < n; d0 += ROWS) {
+            const long rows = std::min(ROWS, n - d0);
+            std::vector<double> Y((size_t)keep * ROWS, 0.0);
+            for (int i = 0; i < mEff; i++) {
+                const double* v = &V[(size_t)i * n + d0];
+                for (int q = 0; q < keep; q++) {
+                    const double sq = S[(size_t)i * mEff + q];
+                    double* y = &Y[(size_t)q * ROWS];
+                    for (long r = 0; r < rows; r++) y[r] += sq * v[r];
+                }
+            }
+            for (int q = 0; q < keep; q++)
+                std::copy(&Y[(size_t)q * ROWS], &Y[(size_t)q * ROWS] + rows, &V[(size_t)q * n + d0]);
+        }
+
+        if (done) {
+            thetaOut.assign(theta.begin(), theta.begin() + kk);
+            phi.assign(V.begin(), V.begin() + (size_t)kk * n);
+            return conv;
+        }
+
+        // Debeli restart: p Ritz-ovih vektora + rezidualni pravac
+        std::copy(V.begin() + (size_t)m * n, V.begin() + (size_t)(m + 1) * n,
+                  V.begin() + (size_t)p * n);
+        std::fill(T.begin(), T.end(), 0.0);
+        for (int q = 0; q < p; q++) {
+            T[(size_t)q * m + q] = theta[q];
+            T[(size_t)p * m + q] = T[(size_t)q * m + p] = beta * S[(size_t)(mEff - 1) * mEff + q];
+        }
+        kept = p;
+    }
+    return 0;
+}
+
+// ─────────────────────────────────────────────
+//  runEigen
+// ─────────────────────────────────────────────
+bool runEigen(const EigenParams& p)
+{
+    if (!validateModel()) {
+        printf("  [GRESKA] Analiza prekinuta — model nije ispravan\n\n");
+        return false;
+    }
+    if (p.kind == EIGEN_BUCKLING && app.forces.empty()) {
+        printf("  [GRESKA] Izvijanje trazi opterecenje — zadajte bar jednu silu\n\n");
+        return false;
+    }
+
+    const int  nN = (int)app.nodes.size();
+    const int  nE = (int)app.elements.size();
+    const int  nS = (int)app.sections.size();
+    const long n  = 2 * (long)nN;
+
+    TrussSymbolic sym;
+    buildSymbolic(sym);
+
+    // Staticko resenje daje faktorisanu K (i sile za K_G)
+    std::vector<double> E(nS), A(nS), Fx(nN, 0.0), Fy(nN, 0.0);
+    for (int s = 0; s < nS; s++) { E[s] = app.sections[s].E; A[s] = app.sections[s].A; }
+    if (p.kind == EIGEN_BUCKLING)
+        for (const Force& f : app.forces) {
+            Fx[f.node] += f.magnitude * cos(f.angle);
+            Fy[f.node] += f.magnitude * sin(f.angle);
+        }
+    TrussWorkspace ws;
+    if (!solveNumericSections(sym, E.data(), A.data(), Fx.data(), Fy.data(), ws)) {
+        printf("  [GRESKA] Matrica krutosti je singularna — sistem je mehanizam\n\n");
+        return false;
+    }
+
+    EigenOperators op;
+    op.sym  = &sym;
+    op.K    = &ws.K;
+    op.kind = p.kind;
+    op.mass = p.mass;
+    op.EA.resize(nE);
+    op.m.resize(nE);
+    op.lumped.assign(nN, 0.0);
+    std::vector<double> diag(n, 0.0);
+    for (int i = 0; i < nE; i++) {
+        const Section& s = sectionOf(app.elements[i]);
+        op.EA[i] = (double)s.E * s.A;
+        op.m[i]  = (double)s.rho * s.A * sym.L[i];
+        op.lumped[sym.n1[i]] += 0.5 * op.m[i];
+        op.lumped[sym.n2[i]] += 0.5 * op.m[i];
+        const double k = op.EA[i] / sym.L[i];
+        const double kx = k * sym.cx[i] * sym.cx[i], ky = k * sym.cy[i] * sym.cy[i];
+        diag[2*sym.n1[i]] += kx; diag[2*sym.n1[i] + 1] += ky;
+        diag[2*sym.n2[i]] += kx; diag[2*sym.n2[i] + 1] += ky;
+    }
+    // Ista kaznena krutost kao u faktorisanoj K
+    double maxDiag = *std::max_element(diag.begin(), diag.end());
+    op.pen = SUPPORT_PENALTY * (maxDiag > 0.0 ? maxDiag : 1.0);
+    std::vector<double>().swap(diag);
+
+    if (p.kind == EIGEN_MODAL) {
+        for (int i = 0; i < nN; i++)
+            if (op.lumped[i] <= 0.0) {
+                printf("  [GRESKA] Cvor %s nema masu (gustina stapova je 0)\n\n",
+                       nodeLabel(i).c_str());
+                return false;
+            }
+    } else {
+        op.N = ws.N;
+        bool compressed = false;
+        for (int i = 0; i < nE; i++) compressed |= (op.N[i] < 0.0);
+        if (!compressed) {
+            printf("  [INFO] Nijedan stap nije pritisnut — nema izvijanja za ovo opterecenje\n\n");
+            return false;
+        }
+    }
+    // Pomeranja statickog resenja vise nisu potrebna
+    std::vector<double>().swap(ws.u);
+    std::vector<double>().swap(ws.rhs);
+
+    const int k = std::max(1, (int)std::min<long>(p.modes, n));
+    std::vector<double> theta, phi;
+    int  restarts = 0;
+    long opCount  = 0;
+    int  conv = lanczos(op, n, k, p.tol, p.restarts, theta, phi, restarts, opCount);
+
+    // Samo pozitivne theta imaju smisla (lambda = 1 / theta; theta ispod
+    // 1e-8 najvece je numericka nula — pravac bez K_G / mase). Parovi cija je
+    // energija vecinom u kaznenim vezama oslonaca nisu fizicki — izostavljaju se.
+    std::vector<int> keep;
+    int penaltyModes = 0;
+    {
+        std::vector<double> Kx(n);
+        const double zero = theta.empty() ? 0.0 : 1e-8 * fabs(theta[0]);
+        for (int q = 0; q < (int)theta.size() && theta[q] > zero; q++) {
+            const double* v = &phi[(size_t)q * n];
+            stiffMul(op, v, Kx.data());
+            double total = dot(v, Kx.data(), n), sup = 0.0;
+            for (size_t l = 0; l < sym.supNode.size(); l++) {
+                const int    nd = sym.supNode[l];
+                const double d  = sym.supNx[l] * v[2*nd] + sym.supNy[l] * v[2*nd + 1];
+                sup += op.pen * d * d;
+            }
+            if (sup > 0.5 * total) penaltyModes++;
+            else                   keep.push_back(q);
+        }
+    }
+    const int nModes = (int)keep.size();
+
+    shapes.kind   = p.kind;
+    shapes.nNodes = nN;
+    shapes.nModes = nModes;
+    shapes.value.resize(nModes);
+    shapes.shape.resize((size_t)nModes * n);
+
+    if (p.kind == EIGEN_MODAL)
+        printf("\n  --- Modalna analiza (%s masa, %ld DOF) ---\n",
+               p.mass == MASS_LUMPED ? "koncentrisana" : "konzistentna", n);
+    else
+        printf("\n  --- Linearno izvijanje (%ld DOF) ---\n", n);
+    printf("  Lanczos: %d restarta, %ld primena operatora, konvergiralo %d od %d\n",
+           restarts, opCount, conv, (int)theta.size());
+    if (penaltyModes > 0)
+        printf("  [INFO] Izostavljeno %d modova u vezama oslonaca (model ima manje slobodnih DOF)\n",
+               penaltyModes);
+
+    if (p.kind == EIGEN_MODAL) printf("  mod    omega [rad/s]    f [Hz]          T [s]\n");
+    else                       printf("  mod    faktor opterecenja\n");
+    for (int j = 0; j < nModes; j++) {
+        const int    q      = keep[j];
+        const double lambda = 1.0 / theta[q];
+        if (p.kind == EIGEN_MODAL) {
+            const double omega = sqrt(lambda);
+            shapes.value[j] = omega / (2.0 * M_PI);
+            printf("  %-5d  %.6e    %.6e    %.6e%s\n", j + 1, omega, shapes.value[j],
+                   1.0 / shapes.value[j], q < conv ? "" : "  (nije konvergiralo)");
+        } else {
+            shapes.value[j] = lambda;
+            printf("  %-5d  %.6e%s\n", j + 1, lambda, q < conv ? "" : "  (nije konvergiralo)");
+        }
+
+        // Oblik normiran na najvece pomeranje cvora = 1
+        const double* v = &phi[(size_t)q * n];
+        double vmax = 0.0;
+        for (int i = 0; i < nN; i++) vmax = std::max(vmax, hypot(v[2*i], v[2*i + 1]));
+        float* out = &shapes.shape[(size_t)j * n];
+        for (long d = 0; d < n; d++) out[d] = (float)(vmax > 0.0 ? v[d] / vmax : 0.0);
+    }
+    if (p.kind == EIGEN_BUCKLING && nModes == 0)
+        printf("  [INFO] Nije pronadjen pozitivan faktor — konstrukcija ne izvija pod ovim opterecenjem\n");
+    if (p.kind == EIGEN_BUCKLING && nModes > 0)
+        printf("  Kriticno opterecenje = faktor x zadate sile\n");
+    printf("\n");
+    return nModes > 0;
+}
@@ -0,0 +1,49 @@
+#ifndef MODAL_H
+#define MODAL_H
+
+#include <vector>
+
+// ─────────────────────────────────────────────
+//  Modalna analiza i linearno izvijanje
+// ─────────────────────────────────────────────
+enum EigenKind {
+    EIGEN_MODAL,      // K phi = omega^2 M phi
+    EIGEN_BUCKLING    // (K + lambda K_G) phi = 0, K_G iz sila staticnog proracuna
+};
+
+enum MassType {
+    MASS_LUMPED,      // rho * A * L / 2 po kraju stapa
+    MASS_CONSISTENT   // rho * A * L / 6 * [2I I; I 2I]
+};
+
+struct EigenParams {
+    EigenKind kind     = EIGEN_MODAL;
+    MassType  mass     = MASS_LUMPED;
+    int       modes    = 6;        // najnizih vlastitih parova
+    double    tol      = 1e-6;     // relativni rezidual Ritz-ovog para
+    int       restarts = 100;
+};
+
+// Sopstveni oblici poslednje uspesne analize (za prikaz)
+struct ModeShapes {
+    EigenKind kind   = EIGEN_MODAL;
+    int       nNodes = 0;
+    int       nModes = 0;
+    std::vector<double> value;   // f [Hz] (modalna) ili faktor opterecenja (izvijanje)
+    std::vector<float>  shape;   // nModes * 2 * nNodes, najvece pomeranje cvora = 1
+};
+
+// Lanczos sa obrnutim operatorom (shift-invert, pomak 0) i debelim
+// restartom (Krylov–Schur). Operator K^-1 M (odnosno K^-1 (-K_G)) se
+// primenjuje kroz skyline Choleski faktor K iz staticnog resavaca, a
+// M i K_G se mnoze stap po stap bez sklapanja. Memorija: profil K plus
+// m + 1 baznih vektora (m ~ 2 * modes + 10) — linearno po broju cvorova.
+//
+// Izvijanje je globalno (resetka sa zglobovima): K_G ima samo poprecni
+// deo N / L * n n^T, pa izvijanje pojedinacnog stapa (Euler, EI) nije
+// obuhvaceno.
+bool runEigen(const EigenParams& p);
+
+const ModeShapes& lastModeShapes();
+
+#endif
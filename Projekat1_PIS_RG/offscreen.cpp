@@ -0,0 +1,376 @@
+#include "offscreen.h"
+#include "window.h"
+#include "utils.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <zlib.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+static const int TILE = 1024;   // piksela, stranica plocice
+
+// ─────────────────────────────────────────────
+//  PNG sa zlib kompresijom, upis red po red
+// ─────────────────────────────────────────────
+struct PngWriter {
+    FILE*                      f = nullptr;
+    z_stream                   zs;
+    std::vector<unsigned char> out = std::vector<unsigned char>(1 << 16);
+    bool                       ok = true;
+
+    void chunk(const char* type, const unsigned char* data, uInt len)
+    {
+        unsigned char hdr[8] = { (unsigned char)(len >> 24), (unsigned char)(len >> 16),
+                                 (unsigned char)(len >> 8),  (unsigned char)len,
+                                 (unsigned char)type[0], (unsigned char)type[1],
+                                 (unsigned char)type[2], (unsigned char)type[3] };
+        uLong crc = crc32(0L, hdr + 4, 4);
+        if (len) crc = crc32(crc, data, len);
+        unsigned char tail[4] = { (unsigned char)(crc >> 24), (unsigned char)(crc >> 16),
+                                  (unsigned char)(crc >> 8),  (unsigned char)crc };
+        ok = fwrite(hdr, 1, 8, f) == 8 && ok;
+        if (len) ok = fwrite(data, 1, len, f) == len && ok;
+        ok = fwrite(tail, 1, 4, f) == 4 && ok;
+    }
+
+    // Prazni izlazni bafer deflate-a u IDAT delove
+    void pump(int flush)
+    {
+        do {
+            zs.next_out  = out.data();
+            zs.avail_out = (uInt)out.size();
+            deflate(&zs, flush);
+            uInt have = (uInt)out.size() - zs.avail_out;
+            if (have) chunk("IDAT", out.data(), have);
+        } while (zs.avail_out == 0);
+    }
+
+    bool open(const char* path, int w, int h)
+    {
+        f = fopen(path, "wb");
+        if (!f) return false;
+        static const unsigned char sig[8] = { 137, 'P', 'N', 'G', 13, 10, 26, 10 };
+        fwrite(sig, 1, 8, f);
+        unsigned char ihdr[13] = { (unsigned char)(w >> 24), (unsigned char)(w >> 16),
+                                   (unsigned char)(w >> 8),  (unsigned char)w,
+                                   (unsigned char)(h >> 24), (unsigned char)(h >> 16),
+                                   (unsigned char)(h >> 8),  (unsigned char)h,
+                                   8, 2, 0, 0, 0 };   // 8 bita, RGB
+        chunk("IHDR", ihdr, 13);
+        memset(&zs, 0, sizeof(zs));
+        // Slike su uglavnom bele — najbrzi nivo daje skoro istu velicinu
+        return deflateInit(&zs, Z_BEST_SPEED) == Z_OK;
+    }
+
+    void writeRow(const unsigned char* rgb, int w)
+    {
+        unsigned char filter = 0;
+        zs.next_in  = &filter;
+        zs.avail_in = 1;
+        pump(Z_NO_FLUSH);
+        zs.next_in  = const_cast<unsigned char*>(rgb);
+        zs.avail_in = (uInt)(3 * w);
+        pump(Z_NO_FLUSH);
+    }
+
+    bool close()
+    {
+        zs.avail_in = 0;
+        pump(Z_FINISH);
+        deflateEnd(&zs);
+        chunk("IEND", nullptr, 0);
+        ok = (fclose(f) == 0) && ok;
+        return ok;
+    }
+};
+
+// ─────────────────────────────────────────────
+//  EGL + FBO
+// ─────────────────────────────────────────────
+static PFNGLGENFRAMEBUFFERSPROC         pglGenFramebuffers;
+static PFNGLBINDFRAMEBUFFERPROC         pglBindFramebuffer;
+static PFNGLGENRENDERBUFFERSPROC        pglGenRenderbuffers;
+static PFNGLBINDRENDERBUFFERPROC        pglBindRenderbuffer;
+static PFNGLRENDERBUFFERSTORAGEPROC     pglRenderbufferStorage;
+static PFNGLFRAMEBUFFERRENDERBUFFERPROC pglFramebufferRenderbuffer;
+static PFNGLCHECKFRAMEBUFFERSTATUSPROC  pglCheckFramebufferStatus;
+
+static EGLDisplay openDisplay(EGLConfig& config)
+{
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+    // Mesa bez X/Wayland: "surfaceless" platforma
+    auto getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+        dpy = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (dpy == EGL_NO_DISPLAY)
+        dpy = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize(dpy, nullptr, nullptr))
+        return EGL_NO_DISPLAY;
+
+    const EGLint attribs[] = { EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLint n = 0;
+    if (!eglChooseConfig(dpy, attribs, &config, 1, &n) || n == 0)
+        config = (EGLConfig)0;   // EGL_KHR_no_config_context
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        eglTerminate(dpy);
+        return EGL_NO_DISPLAY;
+    }
+
+    pglGenFramebuffers         = (PFNGLGENFRAMEBUFFERSPROC)eglGetProcAddress("glGenFramebuffers");
+    pglBindFramebuffer         = (PFNGLBINDFRAMEBUFFERPROC)eglGetProcAddress("glBindFramebuffer");
+    pglGenRenderbuffers        = (PFNGLGENRENDERBUFFERSPROC)eglGetProcAddress("glGenRenderbuffers");
+    pglBindRenderbuffer        = (PFNGLBINDRENDERBUFFERPROC)eglGetProcAddress("glBindRenderbuffer");
+    pglRenderbufferStorage     = (PFNGLRENDERBUFFERSTORAGEPROC)eglGetProcAddress("glRenderbufferStorage");
+    pglFramebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFERPROC)eglGetProcAddress("glFramebufferRenderbuffer");
+    pglCheckFramebufferStatus  = (PFNGLCHECKFRAMEBUFFERSTATUSPROC)eglGetProcAddress("glCheckFramebufferStatus");
+    if (!pglGenFramebuffers || !pglBindFramebuffer || !pglGenRenderbuffers ||
+        !pglBindRenderbuffer || !pglRenderbufferStorage || !pglFramebufferRenderbuffer ||
+        !pglCheckFramebufferStatus) {
+        eglTerminate(dpy);
+        return EGL_NO_DISPLAY;
+    }
+    return dpy;
+}
+
+// Kontekst niti sa FBO velicine jedne plocice
+static bool makeTileContext(EGLDisplay dpy, EGLConfig config, EGLContext& ctx)
+{
+    // Izbor API-ja vazi po niti — bez ovoga nit dobija GLES kontekst
+    eglBindAPI(EGL_OPENGL_API);
+    ctx = eglCreateContext(dpy, config, EGL_NO_CONTEXT, nullptr);
+    if (ctx == EGL_NO_CONTEXT) return false;
+    if (!eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx)) return false;
+
+    GLuint fbo, rbo;
+    pglGenFramebuffers(1, &fbo);
+    pglBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    pglGenRenderbuffers(1, &rbo);
+    pglBindRenderbuffer(GL_RENDERBUFFER, rbo);
+    pglRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, TILE, TILE);
+    pglFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    return pglCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+// ─────────────────────────────────────────────
+//  Traka plocica koju niti zajedno crtaju
+// ─────────────────────────────────────────────
+// Parametri trake; nit ih kopira pod bravom kad preuzme generaciju, pa
+// glavna nit moze da postavi sledecu traku dok zakasnela nit jos radi
+struct BandParams {
+    int    width = 0, rows = 0, nTiles = 0;
+    double x0 = 0.0, yTop = 0.0, scale = 1.0;   // svet levo/gore, m po pikselu
+    unsigned char* pixels = nullptr;            // rows x width x RGB
+};
+
+struct Band {
+    std::mutex              mtx;
+    std::condition_variable cv;
+    uint32_t generation = 0;  // menja se za svaku novu traku
+    bool quit       = false;
+    int  done       = 0;      // iscrtanih plocica u tekucoj traci
+    int  failed     = 0;      // niti bez GL konteksta
+    // generacija << 32 | sledeca plocica; plocica se uzima samo ako je
+    // generacija ista, pa zakasnela nit ne dira brojac nove trake
+    std::atomic<uint64_t> next{ 0 };
+
+    // Tekuca traka (pise je samo glavna nit, pod bravom)
+    BandParams cur;
+    std::vector<unsigned char> pixels;
+};
+
+// Sledeca plocica trake `gen`, -1 = nema vise (ili je traka zamenjena)
+static int takeTile(Band& b, uint32_t gen, int nTiles)
+{
+    uint64_t v = b.next.load();
+    for (;;) {
+        if ((uint32_t)(v >> 32) != gen || (int)(uint32_t)v >= nTiles) return -1;
+        if (b.next.compare_exchange_weak(v, v + 1)) return (int)(uint32_t)v;
+    }
+}
+
+static void renderTile(const BandParams& b, int tile, std::vector<unsigned char>& tmp)
+{
+    int px = tile * TILE;
+    int tw = std::min(TILE, b.width - px);
+    int th = b.rows;
+    float xMin = (float)(b.x0 + px * b.scale);
+    float xMax = (float)(b.x0 + (px + tw) * b.scale);
+    float yMax = (float)b.yTop;
+    float yMin = (float)(b.yTop - th * b.scale);
+
+    renderView(xMin, xMax, yMin, yMax, tw, th);
+    glReadPixels(0, 0, tw, th, GL_RGB, GL_UNSIGNED_BYTE, tmp.data());
+
+    // GL cita odozdo nagore, PNG ide odozgo
+    for (int r = 0; r < th; r++)
+        memcpy(&b.pixels[(3 * (size_t)r * b.width) + 3 * px],
+               &tmp[3 * (size_t)(th - 1 - r) * tw], 3 * (size_t)tw);
+}
+
+static void workerLoop(Band& b, EGLDisplay dpy, EGLConfig config)
+{
+    EGLContext ctx;
+    bool ok = makeTileContext(dpy, config, ctx);
+    std::vector<unsigned char> tmp(3 * (size_t)TILE * TILE);
+
+    uint32_t   seen = 0;
+    BandParams band;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(b.mtx);
+            if (!ok) { b.failed++; b.cv.notify_all(); break; }
+            b.cv.wait(lock, [&] { return b.quit || b.generation != seen; });
+            if (b.quit) break;
+            seen = b.generation;
+            band = b.cur;
+        }
+        int count = 0;
+        for (int t; (t = takeTile(b, seen, band.nTiles)) >= 0; count++)
+            renderTile(band, t, tmp);
+        {
+            std::lock_guard<std::mutex> lock(b.mtx);
+            if (b.generation == seen) b.done += count;
+        }
+        b.cv.notify_all();
+    }
+    eglMakeCurrent(dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (ctx != EGL_NO_CONTEXT) eglDestroyContext(dpy, ctx);
+}
+
+// ─────────────────────────────────────────────
+//  renderJobs
+// ─────────────────────────────────────────────
+bool renderJobs(const std::vector<RenderJob>& jobs, int threads)
+{
+    EGLConfig  config;
+    EGLDisplay dpy = openDisplay(config);
+    if (dpy == EGL_NO_DISPLAY) {
+        printf("  [GRESKA] EGL/OpenGL nije dostupan za offscreen renderovanje\n");
+        return false;
+    }
+
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    Band b;
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++)
+        workers.emplace_back(workerLoop, std::ref(b), dpy, config);
+
+    bool allOk = true;
+    for (const RenderJob& job : jobs) {
+        if (!job.model.empty() && !loadCompact(job.model.c_str())) { allOk = false; continue; }
+        if (job.width <= 0 || job.height <= 0) { allOk = false; continue; }
+
+        // Ceo model sa marginom za oslonce i strelice sila
+        float xMin = -10.0f, xMax = 10.0f, yMin = -10.0f, yMax = 10.0f;
+        if (!app.nodes.empty()) {
+            xMin = xMax = app.nodes[0].x;
+            yMin = yMax = app.nodes[0].y;
+            for (const Node& n : app.nodes) {
+                xMin = std::min(xMin, n.x); xMax = std::max(xMax, n.x);
+                yMin = std::min(yMin, n.y); yMax = std::max(yMax, n.y);
+            }
+            xMin -= 2.0f; xMax += 2.0f; yMin -= 2.0f; yMax += 2.0f;
+        }
+        double scale = std::max((xMax - xMin) / (double)job.width,
+                                (yMax - yMin) / (double)job.height);
+        double cx = 0.5 * (xMin + xMax), cy = 0.5 * (yMin + yMax);
+
+        PngWriter png;
+        if (!png.open(job.png.c_str(), job.width, job.height)) {
+            printf("  [GRESKA] Nije moguce otvoriti %s za pisanje!\n", job.png.c_str());
+            allOk = false;
+            continue;
+        }
+
+        bool jobOk = true;
+        for (int y = 0; y < job.height && jobOk; y += TILE) {
+            {
+                std::unique_lock<std::mutex> lock(b.mtx);
+                BandParams& c = b.cur;
+                c.width  = job.width;
+                c.rows   = std::min(TILE, job.height - y);
+                c.nTiles = (job.width + TILE - 1) / TILE;
+                c.x0     = cx - 0.5 * job.width * scale;
+                c.yTop   = cy + 0.5 * job.height * scale - y * scale;
+                c.scale  = scale;
+                b.pixels.resize(3 * (size_t)c.rows * c.width);
+                c.pixels = b.pixels.data();
+                b.done   = 0;
+                b.generation++;
+                b.next   = (uint64_t)b.generation << 32;
+                b.cv.notify_all();
+                b.cv.wait(lock, [&] { return b.done == c.nTiles || b.failed == threads; });
+                if (b.done != c.nTiles) jobOk = false;
+            }
+            for (int r = 0; r < b.cur.rows && jobOk; r++)
+                png.writeRow(&b.pixels[3 * (size_t)r * b.cur.width], b.cur.width);
+        }
+        jobOk = png.close() && jobOk;
+        if (jobOk)
+            printf("  [OK] %s (%dx%d)\n", job.png.c_str(), job.width, job.height);
+        else
+            printf("  [GRESKA] Renderovanje %s nije uspelo\n", job.png.c_str());
+        allOk = allOk && jobOk;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(b.mtx);
+        b.quit = true;
+    }
+    b.cv.notify_all();
+    for (std::thread& t : workers) t.join();
+    eglTerminate(dpy);
+    return allOk;
+}
+
+// ─────────────────────────────────────────────
+//  runRenderCommand
+// ─────────────────────────────────────────────
+int runRenderCommand(int argc, char** argv)
+{
+    std::vector<RenderJob> jobs;
+
+    if (argc >= 4 && strcmp(argv[1], "--render") == 0) {
+        RenderJob j;
+        j.model = argv[2];
+        j.png   = argv[3];
+        if (argc >= 6) { j.width = atoi(argv[4]); j.height = atoi(argv[5]); }
+        jobs.push_back(j);
+    } else if (argc >= 3 && strcmp(argv[1], "--render-list") == 0) {
+        FILE* f = fopen(argv[2], "r");
+        if (!f) {
+            printf("  [GRESKA] Nije moguce otvoriti %s!\n", argv[2]);
+            return 1;
+        }
+        char line[1024];
+        while (fgets(line, sizeof(line), f)) {
+            char model[480], png[480];
+            RenderJob j;
+            int n = sscanf(line, "%479s %479s %d %d", model, png, &j.width, &j.height);
+            if (n < 2 || model[0] == '#') continue;
+            j.model = model;
+            j.png   = png;
+            jobs.push_back(j);
+        }
+        fclose(f);
+    } else {
+        printf("Upotreba: %s --render model.ulzb slika.png [sirina visina]\n"
+               "          %s --render-list spisak.txt\n", argv[0], argv[0]);
+        return 1;
+    }
+
+    return renderJobs(jobs) ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+#include <string>
+#include <vector>
+
+// ─────────────────────────────────────────────
+//  Renderovanje modela u PNG bez prozora (EGL + FBO, npr. llvmpipe)
+// ─────────────────────────────────────────────
+struct RenderJob {
+    std::string model;    // .ulzb (prazno = trenutni `app`)
+    std::string png;
+    int         width  = 1600;
+    int         height = 1200;
+};
+
+// Slika se deli na plocice TILE x TILE koje crta `threads` niti (0 = sve
+// jezgre), svaka u svom GL kontekstu. PNG se pise u trakama visine jedne
+// plocice, pa memorija ne zavisi od visine slike. Konteksti se prave
+// jednom za ceo spisak poslova.
+bool renderJobs(const std::vector<RenderJob>& jobs, int threads = 0);
+
+// Komandna linija:  --render model.ulzb slika.png [sirina visina]
+//                   --render-list spisak.txt   (linije: model png [w h])
+int  runRenderCommand(int argc, char** argv);
+
+#endif
@@ -0,0 +1,284 @@
+#include "picking.h"
+#include "utils.h"
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+// ─────────────────────────────────────────────
+//  BVH nad stapovima
+// ─────────────────────────────────────────────
+// Cvor drzi AABB; list (count > 0) pokazuje na prim[first .. first+count).
+// Deca se cuvaju eksplicitno, pa se novo podstablo moze prikaciti bez
+// pomeranja postojecih cvorova.
+struct BVHNode {
+    float x0, y0, x1, y1;
+    int   left, right;
+    int   first, count;
+};
+
+static const int LEAF       = 4;     // stapova po listu
+static const int TAIL_MAX   = 256;   // novi stapovi koji se pretrazuju linearno
+static const int MAX_MERGES = 16;    // prikacenih podstabala pre potpune izgradnje
+
+static std::vector<BVHNode> bvh;
+static std::vector<int>     prim;      // indeksi stapova poredjani po listovima
+static std::vector<float>   seg;       // x1, y1, x2, y2 po stapu (indeks stapa)
+static int  root    = -1;
+static int  indexed = 0;               // stapovi [0, indexed) su u stablu
+static int  merges  = 0;
+static bool valid   = false;
+
+void pickInvalidate()
+{
+    valid = false;
+}
+
+static void loadSegments(int from, int to)
+{
+    seg.resize(4 * (size_t)to);
+    for (int i = from; i < to; i++) {
+        const Element& e = app.elements[i];
+        float* s = &seg[4 * (size_t)i];
+        s[0] = app.nodes[e.n1].x; s[1] = app.nodes[e.n1].y;
+        s[2] = app.nodes[e.n2].x; s[3] = app.nodes[e.n2].y;
+    }
+}
+
+// Podela po medijani centroida duz duze ose → dubina ~ log2(n / LEAF)
+static int build(int b, int e)
+{
+    int id = (int)bvh.size();
+    bvh.push_back(BVHNode());
+
+    float x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+    float cx0 = INFINITY, cy0 = INFINITY, cx1 = -INFINITY, cy1 = -INFINITY;
+    for (int k = b; k < e; k++) {
+        const float* s = &seg[4 * (size_t)prim[k]];
+        x0 = std::min(x0, std::min(s[0], s[2])); x1 = std::max(x1, std::max(s[0], s[2]));
+        y0 = std::min(y0, std::min(s[1], s[3])); y1 = std::max(y1, std::max(s[1], s[3]));
+        float cx = s[0] + s[2], cy = s[1] + s[3];
+        cx0 = std::min(cx0, cx); cx1 = std::max(cx1, cx);
+        cy0 = std::min(cy0, cy); cy1 = std::max(cy1, cy);
+    }
+
+    int left = -1, right = -1, first = b, count = e - b;
+    if (e - b > LEAF) {
+        int axis = (cx1 - cx0 >= cy1 - cy0) ? 0 : 1;
+        int mid  = (b + e) / 2;
+        std::nth_element(prim.begin() + b, prim.begin() + mid, prim.begin() + e,
+                         [axis](int p, int q) {
+                             return seg[4*(size_t)p + axis] + seg[4*(size_t)p + 2 + axis] <
+                                    seg[4*(size_t)q + axis] + seg[4*(size_t)q + 2 + axis];
+                         });
+        left  = build(b, mid);
+        right = build(mid, e);
+        first = 0;
+        count = 0;
+    }
+    // bvh se mogao realocirati tokom rekurzije — upis tek na kraju
+    bvh[id] = BVHNode{ x0, y0, x1, y1, left, right, first, count };
+    return id;
+}
+
+static void rebuild()
+{
+    int n = (int)app.elements.size();
+    bvh.clear();
+    bvh.reserve(2 * (size_t)(n / LEAF + 1));
+    prim.resize(n);
+    for (int i = 0; i < n; i++) prim[i] = i;
+    loadSegments(0, n);
+    root    = (n > 0) ? build(0, n) : -1;
+    indexed = n;
+    merges  = 0;
+    valid   = true;
+}
+
+// Dovodi stablo u sklad sa app.elements
+static void sync()
+{
+    int n = (int)app.elements.size();
+    if (!valid || n < indexed) { rebuild(); return; }
+    if (n - indexed <= TAIL_MAX) {
+        loadSegments(indexed, n);   // rep se pretrazuje linearno
+        return;
+    }
+    if (root < 0 || merges >= MAX_MERGES) { rebuild(); return; }
+
+    // Rep dobija svoje podstablo; novi koren obuhvata staro stablo i rep
+    loadSegments(indexed, n);
+    for (int i = indexed; i < n; i++) prim.push_back(i);
+    int sub = build(indexed, n);
+    const BVHNode& a = bvh[root];
+    const BVHNode& c = bvh[sub];
+    BVHNode top = { std::min(a.x0, c.x0), std::min(a.y0, c.y0),
+                    std::max(a.x1, c.x1), std::max(a.y1, c.y1), root, sub, 0, 0 };
+    bvh.push_back(top);
+    root    = (int)bvh.size() - 1;
+    indexed = n;
+    merges++;
+}
+
+// ─────────────────────────────────────────────
+//  Geometrija
+// ─────────────────────────────────────────────
+static float segDist2(float px, float py, const float* s)
+{
+    float dx = s[2] - s[0], dy = s[3] - s[1];
+    float L2 = dx*dx + dy*dy;
+    float t  = (L2 > 0.0f) ? ((px - s[0])*dx + (py - s[1])*dy) / L2 : 0.0f;
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    float ex = s[0] + t*dx - px, ey = s[1] + t*dy - py;
+    return ex*ex + ey*ey;
+}
+
+static float boxDist2(const BVHNode& b, float px, float py)
+{
+    float dx = std::max(std::max(b.x0 - px, px - b.x1), 0.0f);
+    float dy = std::max(std::max(b.y0 - py, py - b.y1), 0.0f);
+    return dx*dx + dy*dy;
+}
+
+// Parnost preseka horizontalne poluprave sa ivicama poligona
+static bool insidePolygon(const std::vector<float>& xy, float px, float py)
+{
+    int  n  = (int)xy.size() / 2;
+    bool in = false;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        float xi = xy[2*i], yi = xy[2*i+1], xj = xy[2*j], yj = xy[2*j+1];
+        if ((yi > py) != (yj > py) &&
+            px < (xj - xi) * (py - yi) / (yj - yi) + xi)
+            in = !in;
+    }
+    return in;
+}
+
+static float cross(float ax, float ay, float bx, float by, float cx, float cy)
+{
+    return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+}
+
+// Stap je u lasu ako su mu oba kraja unutra i ne sece nijednu ivicu
+// (konkavno laso moze da "preseca" stap izmedju krajeva)
+static bool segInLasso(const std::vector<float>& xy, const float* s)
+{
+    if (!insidePolygon(xy, s[0], s[1]) || !insidePolygon(xy, s[2], s[3])) return false;
+    int n = (int)xy.size() / 2;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        float ax = xy[2*j], ay = xy[2*j+1], bx = xy[2*i], by = xy[2*i+1];
+        float d1 = cross(s[0], s[1], s[2], s[3], ax, ay);
+        float d2 = cross(s[0], s[1], s[2], s[3], bx, by);
+        float d3 = cross(ax, ay, bx, by, s[0], s[1]);
+        float d4 = cross(ax, ay, bx, by, s[2], s[3]);
+        if (((d1 > 0) != (d2 > 0)) && ((d3 > 0) != (d4 > 0))) return false;
+    }
+    return true;
+}
+
+// ─────────────────────────────────────────────
+//  Upiti
+// ─────────────────────────────────────────────
+int pickNearest(float x, float y, float maxDist)
+{
+    sync();
+    int   best  = -1;
+    float bestD = maxDist * maxDist;
+
+    int stack[64], sp = 0;
+    if (root >= 0) stack[sp++] = root;
+    while (sp > 0) {
+        const BVHNode& nd = bvh[stack[--sp]];
+        if (boxDist2(nd, x, y) > bestD) continue;
+        if (nd.count > 0) {
+            for (int k = nd.first; k < nd.first + nd.count; k++) {
+                float d = segDist2(x, y, &seg[4 * (size_t)prim[k]]);
+                if (d <= bestD) { bestD = d; best = prim[k]; }
+            }
+            continue;
+        }
+        // Blize dete se obilazi prvo (ide poslednje na stek)
+        float dl = boxDist2(bvh[nd.left], x, y), dr = boxDist2(bvh[nd.right], x, y);
+        if (dl < dr) { stack[sp++] = nd.right; stack[sp++] = nd.left; }
+        else         { stack[sp++] = nd.left;  stack[sp++] = nd.right; }
+    }
+
+    for (int i = indexed; i < (int)app.elements.size(); i++) {
+        float d = segDist2(x, y, &seg[4 * (size_t)i]);
+        if (d <= bestD) { bestD = d; best = i; }
+    }
+    return best;
+}
+
+// Svi stapovi podstabla (ceo cvor je unutar oblasti)
+static void collect(int id, std::vector<int>& out)
+{
+    const BVHNode& nd = bvh[id];
+    if (nd.count > 0) {
+        out.insert(out.end(), prim.begin() + nd.first, prim.begin() + nd.first + nd.count);
+        return;
+    }
+    collect(nd.left, out);
+    collect(nd.right, out);
+}
+
+void pickRect(float x1, float y1, float x2, float y2, std::vector<int>& out)
+{
+    sync();
+    float rx0 = std::min(x1, x2), rx1 = std::max(x1, x2);
+    float ry0 = std::min(y1, y2), ry1 = std::max(y1, y2);
+    auto inside = [&](const float* s) {
+        return s[0] >= rx0 && s[0] <= rx1 && s[2] >= rx0 && s[2] <= rx1 &&
+               s[1] >= ry0 && s[1] <= ry1 && s[3] >= ry0 && s[3] <= ry1;
+    };
+
+    int stack[64], sp = 0;
+    if (root >= 0) stack[sp++] = root;
+    while (sp > 0) {
+        int id = stack[--sp];
+        const BVHNode& nd = bvh[id];
+        if (nd.x1 < rx0 || nd.x0 > rx1 || nd.y1 < ry0 || nd.y0 > ry1) continue;
+        if (nd.x0 >= rx0 && nd.x1 <= rx1 && nd.y0 >= ry0 && nd.y1 <= ry1) {
+            collect(id, out);
+            continue;
+        }
+        if (nd.count > 0) {
+            for (int k = nd.first; k < nd.first + nd.count; k++)
+                if (inside(&seg[4 * (size_t)prim[k]])) out.push_back(prim[k]);
+            continue;
+        }
+        stack[sp++] = nd.left;
+        stack[sp++] = nd.right;
+    }
+
+    for (int i = indexed; i < (int)app.elements.size(); i++)
+        if (inside(&seg[4 * (size_t)i])) out.push_back(i);
+}
+
+void pickLasso(const std::vector<float>& xy, std::vector<int>& out)
+{
+    if (xy.size() < 6) return;
+    sync();
+    float lx0 = INFINITY, ly0 = INFINITY, lx1 = -INFINITY, ly1 = -INFINITY;
+    for (size_t i = 0; i < xy.size(); i += 2) {
+        lx0 = std::min(lx0, xy[i]);   lx1 = std::max(lx1, xy[i]);
+        ly0 = std::min(ly0, xy[i+1]); ly1 = std::max(ly1, xy[i+1]);
+    }
+
+    // Stablo odseca samo po okviru lasa; tacan test se radi u listovima
+    int stack[64], sp = 0;
+    if (root >= 0) stack[sp++] = root;
+    while (sp > 0) {
+        const BVHNode& nd = bvh[stack[--sp]];
+        if (nd.x1 < lx0 || nd.x0 > lx1 || nd.y1 < ly0 || nd.y0 > ly1) continue;
+        if (nd.count > 0) {
+            for (int k = nd.first; k < nd.first + nd.count; k++)
+                if (segInLasso(xy, &seg[4 * (size_t)prim[k]])) out.push_back(prim[k]);
+            continue;
+        }
+        stack[sp++] = nd.left;
+        stack[sp++] = nd.right;
+    }
+
+    for (int i = indexed; i < (int)app.elements.size(); i++)
+        if (segInLasso(xy, &seg[4 * (size_t)i])) out.push_back(i);
+}
@@ -0,0 +1,25 @@
+#ifndef PICKING_H
+#define PICKING_H
+
+#include <vector>
+
+// ─────────────────────────────────────────────
+//  Biranje stapova misem (BVH nad duzima stapova)
+// ─────────────────────────────────────────────
+// Hijerarhija se gradi lenjo pri prvom upitu. Novi stapovi (dodati na kraj
+// app.elements) se prvo pretrazuju linearno, a kad ih se skupi dovoljno
+// dobijaju svoje podstablo koje se kaci ispod novog korena; povremeno se
+// sve gradi iz pocetka. Posle brisanja stapova ili ucitavanja modela
+// pozvati pickInvalidate().
+void pickInvalidate();
+
+// Najblizi stap tacki (x, y), ali ne dalji od maxDist; -1 ako ga nema
+int  pickNearest(float x, float y, float maxDist);
+
+// Stapovi cela duz u pravougaoniku (uglovi u bilo kom redosledu)
+void pickRect(float x1, float y1, float x2, float y2, std::vector<int>& out);
+
+// Stapovi cela duz unutar zatvorenog poligona xy = {x0, y0, x1, y1, ...}
+void pickLasso(const std::vector<float>& xy, std::vector<int>& out);
+
+#endif
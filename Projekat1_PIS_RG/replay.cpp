@@ -0,0 +1,464 @@
+#include "replay.h"
+#include "window.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+// ─────────────────────────────────────────────
+//  Dogadjaji
+// ─────────────────────────────────────────────
+static const char    MAGIC[4] = { 'M', 'K', 'E', 'R' };
+static const uint8_t VERSION  = 1;
+
+enum EventType : uint8_t {
+    EV_MOUSE, EV_MOTION, EV_KEY, EV_SPECIAL, EV_RESHAPE,
+    EV_DISPLAY,     // samo za statistiku, ne upisuje se
+    EV_ANSWER,      // odgovor na pitanje u terminalu
+    EV_COUNT
+};
+
+static const char* EVENT_NAME[EV_COUNT] = {
+    "mis", "pomeranje", "taster", "spec. taster", "prozor", "crtanje", "odgovor"
+};
+
+struct InputEvent {
+    uint8_t     type   = EV_KEY;
+    uint32_t    dtUs   = 0;      // od prethodnog dogadjaja
+    int         code   = 0;      // dugme / taster
+    int         state  = 0;
+    int         mods   = 0;
+    int         x = 0, y = 0;    // za EV_RESHAPE: sirina, visina
+    std::string text;            // EV_ANSWER
+};
+
+// ─────────────────────────────────────────────
+//  Histogram latencije (binovi po stepenima dvojke, u mikrosekundama)
+// ─────────────────────────────────────────────
+struct LatencyHist {
+    static const int BINS = 32;   // bin k: [2^(k-1), 2^k) us, bin 0: < 1 us
+    long   count[BINS] = {};
+    long   n   = 0;
+    double sum = 0.0, max = 0.0;
+
+    void add(double us)
+    {
+        int k = (us < 1.0) ? 0 : (int)floor(log2(us)) + 1;
+        if (k >= BINS) k = BINS - 1;
+        count[k]++;
+        n++;
+        sum += us;
+        if (us > max) max = us;
+    }
+    // Gornja granica bina u kome je kvantil q
+    double quantileBound(double q) const
+    {
+        long target = (long)ceil(q * n), acc = 0;
+        for (int k = 0; k < BINS; k++) {
+            acc += count[k];
+            if (acc >= target && acc > 0) return ldexp(1.0, k);
+        }
+        return ldexp(1.0, BINS - 1);
+    }
+};
+
+typedef std::chrono::steady_clock Clock;
+
+static LatencyHist hist[EV_COUNT];
+static int         currentMods  = 0;
+static double      promptWaitUs = 0.0;   // vreme cekanja na korisnika u dogadjaju
+
+// Snimanje
+static FILE*             recFile = nullptr;
+static std::string       recPath;
+static Clock::time_point recLast;
+static long              recCount = 0;
+
+// Ponavljanje
+static bool                 replaying = false;
+static bool                 headless  = false;
+static std::vector<uint8_t> trace;
+static size_t               cursor      = 0;
+static long                 desyncs     = 0;
+static long                 redisplays  = 0;
+static double               budgetMs    = 0.0;
+
+// ─────────────────────────────────────────────
+//  Kodiranje
+// ─────────────────────────────────────────────
+static void putVarint(std::string& out, uint64_t v)
+{
+    while (v >= 0x80) { out += (char)(v | 0x80); v >>= 7; }
+    out += (char)v;
+}
+
+static void putZigzag(std::string& out, int v)
+{
+    putVarint(out, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+static bool getVarint(uint64_t& v)
+{
+    v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (cursor >= trace.size()) return false;
+        uint8_t b = trace[cursor++];
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static bool getInt(int& v)
+{
+    uint64_t u;
+    if (!getVarint(u)) return false;
+    v = (int)u;
+    return true;
+}
+
+static bool getZigzag(int& v)
+{
+    uint64_t u;
+    if (!getVarint(u)) return false;
+    v = (int)((uint32_t)(u >> 1) ^ -(uint32_t)(u & 1));
+    return true;
+}
+
+static void writeEvent(InputEvent& e)
+{
+    Clock::time_point t = Clock::now();
+    e.dtUs  = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(t - recLast).count();
+    recLast = t;
+
+    std::string out;
+    out += (char)e.type;
+    putVarint(out, e.dtUs);
+    switch (e.type) {
+    case EV_MOUSE:
+        putVarint(out, e.code); putVarint(out, e.state); putVarint(out, e.mods);
+        putZigzag(out, e.x);    putZigzag(out, e.y);
+        break;
+    case EV_KEY: case EV_SPECIAL:
+        putVarint(out, e.code); putVarint(out, e.mods);
+        putZigzag(out, e.x);    putZigzag(out, e.y);
+        break;
+    case EV_MOTION:
+        putZigzag(out, e.x); putZigzag(out, e.y);
+        break;
+    case EV_RESHAPE:
+        putVarint(out, e.x); putVarint(out, e.y);
+        break;
+    case EV_ANSWER:
+        putVarint(out, e.text.size());
+        out += e.text;
+        break;
+    }
+    fwrite(out.data(), 1, out.size(), recFile);
+    recCount++;
+}
+
+static bool readEvent(InputEvent& e)
+{
+    if (cursor >= trace.size()) return false;
+    e.type = trace[cursor++];
+    uint64_t dt;
+    if (!getVarint(dt)) return false;
+    e.dtUs = (uint32_t)dt;
+    switch (e.type) {
+    case EV_MOUSE:
+        return getInt(e.code) && getInt(e.state) && getInt(e.mods) &&
+               getZigzag(e.x) && getZigzag(e.y);
+    case EV_KEY: case EV_SPECIAL:
+        return getInt(e.code) && getInt(e.mods) && getZigzag(e.x) && getZigzag(e.y);
+    case EV_MOTION:
+        return getZigzag(e.x) && getZigzag(e.y);
+    case EV_RESHAPE:
+        return getInt(e.x) && getInt(e.y);
+    case EV_ANSWER: {
+        uint64_t len;
+        if (!getVarint(len) || len > trace.size() - cursor) return false;
+        e.text.assign((const char*)&trace[cursor], (size_t)len);
+        cursor += (size_t)len;
+        return true;
+    }
+    }
+    return false;
+}
+
+// ─────────────────────────────────────────────
+//  Obrada dogadjaja (zivo i pri ponavljanju)
+// ─────────────────────────────────────────────
+static void dispatch(InputEvent& e)
+{
+    if (recFile) writeEvent(e);
+    currentMods  = e.mods;
+    promptWaitUs = 0.0;
+
+    Clock::time_point t0 = Clock::now();
+    switch (e.type) {
+    case EV_MOUSE:   handleMouse(e.code, e.state, e.x, e.y);          break;
+    case EV_MOTION:  handleMotion(e.x, e.y);                          break;
+    case EV_KEY:     keyboard((unsigned char)e.code, e.x, e.y);       break;
+    case EV_SPECIAL: specialKeys(e.code, e.x, e.y);                   break;
+    case EV_RESHAPE:                  // headless: nema GL konteksta
+        if (headless) { resizeView(e.x, e.y); requestRedisplay(); }
+        else          reshape(e.x, e.y);
+        break;
+    }
+    double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+    hist[e.type].add(std::max(us - promptWaitUs, 0.0));
+}
+
+void inputDisplay()
+{
+    Clock::time_point t0 = Clock::now();
+    display();
+    hist[EV_DISPLAY].add(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+}
+
+// Pri ponavljanju u prozoru zivi ulaz se ignorise
+void inputReshape(int w, int h)
+{
+    if (replaying) return;
+    InputEvent e; e.type = EV_RESHAPE; e.x = w; e.y = h;
+    dispatch(e);
+}
+
+void inputKeyboard(unsigned char key, int x, int y)
+{
+    if (replaying) return;
+    InputEvent e; e.type = EV_KEY; e.code = key; e.x = x; e.y = y;
+    e.mods = glutGetModifiers();
+    dispatch(e);
+}
+
+void inputSpecial(int key, int x, int y)
+{
+    if (replaying) return;
+    InputEvent e; e.type = EV_SPECIAL; e.code = key; e.x = x; e.y = y;
+    e.mods = glutGetModifiers();
+    dispatch(e);
+}
+
+void inputMouse(int button, int state, int x, int y)
+{
+    if (replaying) return;
+    InputEvent e; e.type = EV_MOUSE; e.code = button; e.state = state; e.x = x; e.y = y;
+    e.mods = glutGetModifiers();
+    dispatch(e);
+}
+
+// GLUT ne daje modifikatore pri pomeranju — vaze oni sa pritiska dugmeta
+void inputMotion(int x, int y)
+{
+    if (replaying) return;
+    InputEvent e; e.type = EV_MOTION; e.x = x; e.y = y; e.mods = currentMods;
+    dispatch(e);
+}
+
+int inputModifiers()
+{
+    return currentMods;
+}
+
+void requestRedisplay()
+{
+    redisplays++;
+    if (!headless) glutPostRedisplay();
+}
+
+// ─────────────────────────────────────────────
+//  Terminalni unos
+// ─────────────────────────────────────────────
+bool promptToken(char* buf, int size)
+{
+    buf[0] = '\0';
+    if (replaying) {
+        size_t     save = cursor;
+        InputEvent e;
+        if (!readEvent(e) || e.type != EV_ANSWER) {
+            // Kod trazi odgovor koji nije snimljen — podrazumevana vrednost
+            cursor = save;
+            desyncs++;
+            printf("(nema odgovora u tragu)\n");
+            return false;
+        }
+        snprintf(buf, size, "%s", e.text.c_str());
+        printf("%s\n", buf);
+        return buf[0] != '\0';
+    }
+
+    Clock::time_point t0 = Clock::now();
+    int c, n = 0;
+    do c = getchar(); while (c != EOF && isspace(c));
+    while (c != EOF && !isspace(c)) {
+        if (n < size - 1) buf[n++] = (char)c;
+        c = getchar();
+    }
+    buf[n] = '\0';
+    promptWaitUs += std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+
+    if (recFile) {
+        InputEvent e; e.type = EV_ANSWER; e.text = buf;
+        writeEvent(e);
+    }
+    return n > 0;
+}
+
+bool promptDouble(double& value)
+{
+    char buf[64];
+    if (!promptToken(buf, sizeof(buf))) return false;
+    char*  end;
+    double v = strtod(buf, &end);
+    if (*end != '\0') return false;
+    value = v;
+    return true;
+}
+
+bool promptInt(int& value)
+{
+    char buf[64];
+    if (!promptToken(buf, sizeof(buf))) return false;
+    char* end;
+    long  v = strtol(buf, &end, 10);
+    if (*end != '\0') return false;
+    value = (int)v;
+    return true;
+}
+
+// ─────────────────────────────────────────────
+//  Izvestaj
+// ─────────────────────────────────────────────
+// Vraca false ako je p99 nekog tipa preko budzeta
+static bool printReport()
+{
+    bool ok = true;
+    printf("\n  --- Latencija obrade dogadjaja [us] ---\n");
+    printf("  tip             broj     srednja     p50 <=     p99 <=         max\n");
+    for (int t = 0; t < EV_COUNT; t++) {
+        const LatencyHist& h = hist[t];
+        if (h.n == 0 || t == EV_ANSWER) continue;
+        double p99 = h.quantileBound(0.99);
+        printf("  %-12s %7ld  %10.1f  %9.0f  %9.0f  %10.1f\n", EVENT_NAME[t], h.n,
+               h.sum / h.n, h.quantileBound(0.50), p99, h.max);
+        if (budgetMs > 0.0 && p99 > budgetMs * 1000.0) {
+            printf("  [GRESKA] %s: p99 premasuje budzet od %.3f ms\n", EVENT_NAME[t], budgetMs);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+// ─────────────────────────────────────────────
+//  Snimanje
+// ─────────────────────────────────────────────
+static void stopRecording()
+{
+    if (!recFile) return;
+    fclose(recFile);
+    recFile = nullptr;
+    printf("\n  [OK] Snimljeno %ld dogadjaja u %s\n", recCount, recPath.c_str());
+    printReport();
+}
+
+bool startRecording(const char* path)
+{
+    recFile = fopen(path, "wb");
+    if (!recFile) {
+        printf("  [GRESKA] Nije moguce otvoriti %s za pisanje!\n", path);
+        return false;
+    }
+    fwrite(MAGIC, 1, 4, recFile);
+    fwrite(&VERSION, 1, 1, recFile);
+    recPath = path;
+    recLast = Clock::now();
+    atexit(stopRecording);
+    printf("  [INFO] Snimanje ulaza u %s\n", path);
+    return true;
+}
+
+// ─────────────────────────────────────────────
+//  Ponavljanje
+// ─────────────────────────────────────────────
+// Obradi sledeci dogadjaj; false kad je trag gotov (ili je stigao 'q')
+static bool replayNext()
+{
+    InputEvent e;
+    for (;;) {
+        if (cursor >= trace.size()) return false;
+        if (!readEvent(e)) {
+            printf("  [GRESKA] Trag je ostecen (bajt %zu)\n", cursor);
+            return false;
+        }
+        if (e.type != EV_ANSWER) break;
+        desyncs++;   // odgovor koji kod vise ne trazi
+    }
+    if (e.type == EV_KEY && (e.code == 'q' || e.code == 'Q')) return false;
+    dispatch(e);
+    return true;
+}
+
+static int finishReplay()
+{
+    printf("\n  [OK] Ponavljanje zavrseno (%zu / %zu bajtova traga, zahteva za crtanje: %ld)\n",
+           cursor, trace.size(), redisplays);
+    if (desyncs > 0)
+        printf("  [UPOZORENJE] Odgovori se ne poklapaju sa pitanjima: %ld\n", desyncs);
+    bool ok = printReport();
+    return (ok && desyncs == 0) ? 0 : 1;
+}
+
+static void replayIdle()
+{
+    if (!replayNext()) exit(finishReplay());
+}
+
+int runReplayCommand(int argc, char** argv)
+{
+    if (argc < 3) {
+        printf("Upotreba: %s --replay trag.mker [--headless] [--budget-ms N]\n", argv[0]);
+        return 1;
+    }
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--headless") == 0) headless = true;
+        else if (strcmp(argv[i], "--budget-ms") == 0 && i + 1 < argc) budgetMs = atof(argv[++i]);
+    }
+
+    FILE* f = fopen(argv[2], "rb");
+    if (!f) {
+        printf("  [GRESKA] Nije moguce otvoriti %s!\n", argv[2]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    trace.resize(size > 0 ? size : 0);
+    size_t got = fread(trace.data(), 1, trace.size(), f);
+    fclose(f);
+    if (got != trace.size() || trace.size() < 5 ||
+        memcmp(trace.data(), MAGIC, 4) != 0 || trace[4] != VERSION) {
+        printf("  [GRESKA] %s nije trag ulaza (verzija %d)\n", argv[2], VERSION);
+        return 1;
+    }
+    cursor    = 5;
+    replaying = true;
+
+    if (headless) {
+        while (replayNext()) {}
+        return finishReplay();
+    }
+
+    int   glutArgc = 1;
+    initWindow(glutArgc, argv, false);
+    glutIdleFunc(replayIdle);
+    glutMainLoop();
+    return 0;
+}
@@ -0,0 +1,43 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+// ─────────────────────────────────────────────
+//  Snimanje ulaza i deterministicko ponavljanje
+// ─────────────────────────────────────────────
+// Svi GLUT ulazni pozivi idu kroz input* omotace: oni mere trajanje
+// obrade dogadjaja (log2 histogram po tipu), a pri snimanju upisuju
+// dogadjaj u binarni trag. Odgovori na pitanja u terminalu se citaju
+// preko prompt* funkcija i upisuju u isti trag, odmah iza dogadjaja
+// koji ih je trazio.
+//
+// Trag:  "MKER", uint8 verzija, zatim dogadjaji:
+//        uint8 tip, varint dt [us], pa podaci po tipu (varint / zigzag)
+
+// Omotaci za glut*Func (registruje ih initWindow)
+void inputDisplay();
+void inputReshape(int w, int h);
+void inputKeyboard(unsigned char key, int x, int y);
+void inputSpecial(int key, int x, int y);
+void inputMouse(int button, int state, int x, int y);
+void inputMotion(int x, int y);
+
+// Modifikatori (GLUT_ACTIVE_*) tekuceg dogadjaja — umesto glutGetModifiers
+int  inputModifiers();
+
+// Umesto glutPostRedisplay (bez prozora samo belezi zahtev)
+void requestRedisplay();
+
+// Terminalni unos: jedna rec sa stdin (ili iz traga pri ponavljanju).
+// Nevazeci unos se odbacuje (false), pa ne ostaje da blokira sledece pitanje.
+bool promptToken(char* buf, int size);
+bool promptDouble(double& value);
+bool promptInt(int& value);
+
+// --record trag.mker  (pre initWindow; trag se zatvara pri izlazu)
+bool startRecording(const char* path);
+
+// --replay trag.mker [--headless] [--budget-ms N]
+// Izlazni kod 1 ako je p99 nekog tipa dogadjaja veci od N ms.
+int  runReplayCommand(int argc, char** argv);
+
+#endif
@@ -0,0 +1,410 @@
+#include "solver.h"
+#include "utils.h"
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+static std::string nodeLabel(int i)
+{
+    std::string s;
+    do {
+        s = (char)('A' + (i % 26)) + s;
+        i = i / 26 - 1;
+    } while (i >= 0);
+    return s;
+}
+
+// ─────────────────────────────────────────────
+//  SkylineMatrix
+// ─────────────────────────────────────────────
+void SkylineMatrix::setProfile(const std::vector<int>& first)
+{
+    n        = (int)first.size();
+    firstRow = first;
+    colStart.assign(n + 1, 0);
+    for (int j = 0; j < n; j++)
+        colStart[j + 1] = colStart[j] + (j - firstRow[j] + 1);
+    vals.assign(colStart[n], 0.0);
+}
+
+void SkylineMatrix::add(int i, int j, double v)
+{
+    if (i > j) std::swap(i, j);
+    vals[index(i, j)] += v;
+}
+
+void SkylineMatrix::clear()
+{
+    std::fill(vals.begin(), vals.end(), 0.0);
+}
+
+// Choleski po kolonama: U_ij = (K_ij - sum_k U_ki U_kj) / U_ii.
+// Unutrasnje sume su skalarni proizvodi uzastopnih delova dve kolone.
+bool SkylineMatrix::factorize(int* badDof)
+{
+    for (int j = 0; j < n; j++) {
+        const int fj = firstRow[j];
+        double*   cj = &vals[colStart[j]] - fj;   // cj[i] = U_ij
+
+        for (int i = fj; i < j; i++) {
+            const int     fi = firstRow[i];
+            const double* ci = &vals[colStart[i]] - fi;
+            const int     k0 = std::max(fi, fj);
+            double s = 0.0;
+            #pragma omp simd reduction(+:s)
+            for (int k = k0; k < i; k++) s += ci[k] * cj[k];
+            cj[i] = (cj[i] - s) / ci[i];
+        }
+
+        double s = 0.0;
+        #pragma omp simd reduction(+:s)
+        for (int k = fj; k < j; k++) s += cj[k] * cj[k];
+        double d = cj[j] - s;
+        if (!(d > 1e-12 * fabs(cj[j]))) {
+            if (badDof) *badDof = j;
+            return false;
+        }
+        cj[j] = sqrt(d);
+    }
+    return true;
+}
+
+void SkylineMatrix::solve(double* b) const
+{
+    // U^T y = b
+    for (int j = 0; j < n; j++) {
+        const int     fj = firstRow[j];
+        const double* cj = &vals[colStart[j]] - fj;
+        double s = 0.0;
+        #pragma omp simd reduction(+:s)
+        for (int k = fj; k < j; k++) s += cj[k] * b[k];
+        b[j] = (b[j] - s) / cj[j];
+    }
+    // U x = y
+    for (int j = n - 1; j >= 0; j--) {
+        const int     fj = firstRow[j];
+        const double* cj = &vals[colStart[j]] - fj;
+        b[j] /= cj[j];
+        const double xj = b[j];
+        #pragma omp simd
+        for (int k = fj; k < j; k++) b[k] -= cj[k] * xj;
+    }
+}
+
+void SkylineMatrix::multiply(const double* x, double* y) const
+{
+    for (int i = 0; i < n; i++) y[i] = 0.0;
+    for (int j = 0; j < n; j++) {
+        const int     fj = firstRow[j];
+        const double* cj = &vals[colStart[j]] - fj;
+        double s = 0.0;
+        for (int k = fj; k < j; k++) {
+            s    += cj[k] * x[k];   // gornji trougao
+            y[k] += cj[k] * x[j];   // simetricni donji
+        }
+        y[j] += s + cj[j] * x[j];
+    }
+}
+
+// ─────────────────────────────────────────────
+//  Simbolicka faza
+// ─────────────────────────────────────────────
+// Obrnuti Cuthill–McKee po cvorovima smanjuje profil (za lance polja
+// profil je reda sirine jednog polja).
+std::vector<int> rcmOrder(const std::vector<std::vector<int>>& adj)
+{
+    const int n = (int)adj.size();
+    std::vector<int>  order;
+    std::vector<char> seen(n, 0);
+    order.reserve(n);
+
+    std::vector<int> byDegree(n);
+    for (int i = 0; i < n; i++) byDegree[i] = i;
+    std::stable_sort(byDegree.begin(), byDegree.end(),
+                     [&](int a, int b) { return adj[a].size() < adj[b].size(); });
+
+    for (int start : byDegree) {
+        if (seen[start]) continue;
+        size_t head = order.size();
+        order.push_back(start);
+        seen[start] = 1;
+        while (head < order.size()) {
+            int v = order[head++];
+            size_t mark = order.size();
+            for (int w : adj[v])
+                if (!seen[w]) { seen[w] = 1; order.push_back(w); }
+            std::sort(order.begin() + mark, order.end(),
+                      [&](int a, int b) { return adj[a].size() < adj[b].size(); });
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+bool buildSymbolic(TrussSymbolic& sym)
+{
+    const int nN = (int)app.nodes.size();
+    const int nE = (int)app.elements.size();
+    sym.nNodes = nN;
+    sym.nElems = nE;
+    sym.nDof   = 2 * nN;
+
+    std::vector<std::vector<int>> adj(nN);
+    for (const Element& e : app.elements) {
+        adj[e.n1].push_back(e.n2);
+        adj[e.n2].push_back(e.n1);
+    }
+    std::vector<int> order = rcmOrder(adj);
+    sym.dofOfNode.assign(nN, 0);
+    for (int k = 0; k < nN; k++) sym.dofOfNode[order[k]] = 2 * k;
+
+    // Profil: za svaku kolonu najmanji red sa kojim je povezana
+    std::vector<int> first(sym.nDof);
+    for (int d = 0; d < sym.nDof; d++) first[d] = d & ~1;   // 2x2 blok cvora
+    for (const Element& e : app.elements) {
+        int a = sym.dofOfNode[e.n1], b = sym.dofOfNode[e.n2];
+        int lo = std::min(a, b), hi = std::max(a, b);
+        first[hi]     = std::min(first[hi], lo);
+        first[hi + 1] = std::min(first[hi + 1], lo);
+    }
+    sym.pattern.setProfile(first);
+
+    sym.n1.resize(nE); sym.n2.resize(nE);
+    sym.cx.resize(nE); sym.cy.resize(nE); sym.L.resize(nE);
+    sym.elemSlot.resize(10 * (size_t)nE);
+    for (int i = 0; i < nE; i++) {
+        const Element& e = app.elements[i];
+        double dx = app.nodes[e.n2].x - app.nodes[e.n1].x;
+        double dy = app.nodes[e.n2].y - app.nodes[e.n1].y;
+        sym.n1[i] = e.n1;
+        sym.n2[i] = e.n2;
+        sym.L[i]  = sqrt(dx*dx + dy*dy);
+        sym.cx[i] = dx / sym.L[i];
+        sym.cy[i] = dy / sym.L[i];
+
+        int dofs[4] = { sym.dofOfNode[e.n1], sym.dofOfNode[e.n1] + 1,
+                        sym.dofOfNode[e.n2], sym.dofOfNode[e.n2] + 1 };
+        long* slot = &sym.elemSlot[10 * (size_t)i];
+        for (int r = 0, k = 0; r < 4; r++)
+            for (int c = r; c < 4; c++, k++) {
+                int a = std::min(dofs[r], dofs[c]), b = std::max(dofs[r], dofs[c]);
+                slot[k] = sym.pattern.index(a, b);
+            }
+    }
+
+    // Stapovi grupisani po sekciji (prebrojavanje)
+    const int nS = (int)app.sections.size();
+    sym.secStart.assign(nS + 1, 0);
+    for (const Element& e : app.elements) sym.secStart[e.section + 1]++;
+    for (int s = 0; s < nS; s++) sym.secStart[s + 1] += sym.secStart[s];
+    sym.secElems.resize(nE);
+    std::vector<int> pos(sym.secStart.begin(), sym.secStart.end() - 1);
+    for (int i = 0; i < nE; i++) sym.secElems[pos[app.elements[i].section]++] = i;
+
+    // Oslonci: nepokretni = dve veze (x, y), pokretni = jedna (upravno na podlogu)
+    sym.supNode.clear(); sym.supNx.clear(); sym.supNy.clear(); sym.supSlot.clear();
+    auto addLink = [&](int node, double nx, double ny) {
+        int d = sym.dofOfNode[node];
+        sym.supNode.push_back(node);
+        sym.supNx.push_back(nx);
+        sym.supNy.push_back(ny);
+        sym.supSlot.push_back(sym.pattern.index(d, d));
+        sym.supSlot.push_back(sym.pattern.index(d, d + 1));
+        sym.supSlot.push_back(sym.pattern.index(d + 1, d + 1));
+    };
+    for (const Support& s : app.supports) {
+        if (s.type == FIXED) {
+            addLink(s.node, 1.0, 0.0);
+            addLink(s.node, 0.0, 1.0);
+        } else {
+            addLink(s.node, -sin(s.angle), cos(s.angle));
+        }
+    }
+    return true;
+}
+
+// ─────────────────────────────────────────────
+//  Numericka faza
+// ─────────────────────────────────────────────
+// Doprinos stapa i (k = EA / L) gornjem trouglu:
+// [ cc cs -cc -cs ; ss -cs -ss ; cc cs ; ss ]
+static inline void addElement(const TrussSymbolic& sym, int i, double k, double* K)
+{
+    const double cc = k * sym.cx[i] * sym.cx[i];
+    const double cs = k * sym.cx[i] * sym.cy[i];
+    const double ss = k * sym.cy[i] * sym.cy[i];
+    const double v[10] = { cc, cs, -cc, -cs, ss, -cs, -ss, cc, cs, ss };
+    const long*  slot  = &sym.elemSlot[10 * (size_t)i];
+    for (int k2 = 0; k2 < 10; k2++) K[slot[k2]] += v[k2];
+}
+
+static inline double axialStrain(const TrussSymbolic& sym, const std::vector<double>& u, int i)
+{
+    const int a = sym.n1[i], c = sym.n2[i];
+    return ((u[2*c]     - u[2*a])     * sym.cx[i] +
+            (u[2*c + 1] - u[2*a + 1]) * sym.cy[i]) / sym.L[i];
+}
+
+static void clearMatrix(const TrussSymbolic& sym, TrussWorkspace& ws)
+{
+    if (ws.K.n != sym.nDof) ws.K = sym.pattern;
+    else                    ws.K.clear();
+}
+
+// Oslonci, faktorizacija i resavanje (K stapova je vec sastavljena)
+static bool supportAndSolve(const TrussSymbolic& sym,
+                            const double* Fx, const double* Fy,
+                            TrussWorkspace& ws)
+{
+    double* K = ws.K.vals.data();
+    double maxDiag = 0.0;
+    for (int d = 0; d < sym.nDof; d++)
+        maxDiag = std::max(maxDiag, K[ws.K.index(d, d)]);
+    const double pen = SUPPORT_PENALTY * (maxDiag > 0.0 ? maxDiag : 1.0);
+    for (size_t l = 0; l < sym.supNode.size(); l++) {
+        const double nx = sym.supNx[l], ny = sym.supNy[l];
+        K[sym.supSlot[3*l]]     += pen * nx * nx;
+        K[sym.supSlot[3*l + 1]] += pen * nx * ny;
+        K[sym.supSlot[3*l + 2]] += pen * ny * ny;
+    }
+
+    if (!ws.K.factorize())
+        return false;
+
+    std::vector<double>& b = ws.rhs;
+    b.resize(sym.nDof);
+    for (int i = 0; i < sym.nNodes; i++) {
+        b[sym.dofOfNode[i]]     = Fx[i];
+        b[sym.dofOfNode[i] + 1] = Fy[i];
+    }
+    ws.K.solve(b.data());
+
+    ws.u.resize(2 * (size_t)sym.nNodes);
+    for (int i = 0; i < sym.nNodes; i++) {
+        ws.u[2*i]     = b[sym.dofOfNode[i]];
+        ws.u[2*i + 1] = b[sym.dofOfNode[i] + 1];
+    }
+    return true;
+}
+
+bool solveNumeric(const TrussSymbolic& sym,
+                  const double* E, const double* A,
+                  const double* Fx, const double* Fy,
+                  TrussWorkspace& ws)
+{
+    clearMatrix(sym, ws);
+    double* K = ws.K.vals.data();
+    for (int i = 0; i < sym.nElems; i++)
+        addElement(sym, i, E[i] * A[i] / sym.L[i], K);
+
+    if (!supportAndSolve(sym, Fx, Fy, ws))
+        return false;
+
+    ws.N.resize(sym.nElems);
+    for (int i = 0; i < sym.nElems; i++)
+        ws.N[i] = E[i] * A[i] * axialStrain(sym, ws.u, i);
+    return true;
+}
+
+// Isto, ali E i A po sekciji: stapovi se obilaze u grupama iste sekcije,
+// pa je EA konstanta unutrasnje petlje
+bool solveNumericSections(const TrussSymbolic& sym,
+                          const double* E, const double* A,
+                          const double* Fx, const double* Fy,
+                          TrussWorkspace& ws)
+{
+    const int nS = (int)sym.secStart.size() - 1;
+    clearMatrix(sym, ws);
+    double* K = ws.K.vals.data();
+    for (int s = 0; s < nS; s++) {
+        const double EA = E[s] * A[s];
+        for (int j = sym.secStart[s]; j < sym.secStart[s + 1]; j++) {
+            const int i = sym.secElems[j];
+            addElement(sym, i, EA / sym.L[i], K);
+        }
+    }
+
+    if (!supportAndSolve(sym, Fx, Fy, ws))
+        return false;
+
+    ws.N.resize(sym.nElems);
+    for (int s = 0; s < nS; s++) {
+        const double EA = E[s] * A[s];
+        for (int j = sym.secStart[s]; j < sym.secStart[s + 1]; j++) {
+            const int i = sym.secElems[j];
+            ws.N[i] = EA * axialStrain(sym, ws.u, i);
+        }
+    }
+    return true;
+}
+
+// ─────────────────────────────────────────────
+//  solveStatic — proracun trenutnog modela
+// ─────────────────────────────────────────────
+bool solveStatic()
+{
+    if (!validateModel()) {
+        printf("  [GRESKA] Proracun prekinut — model nije ispravan\n\n");
+        return false;
+    }
+
+    const int nN = (int)app.nodes.size();
+
+    TrussSymbolic sym;
+    buildSymbolic(sym);
+
+    const int nS = (int)app.sections.size();
+    std::vector<double> E(nS), A(nS), Fx(nN, 0.0), Fy(nN, 0.0);
+    for (int s = 0; s < nS; s++) { E[s] = app.sections[s].E; A[s] = app.sections[s].A; }
+    for (const Force& f : app.forces) {
+        Fx[f.node] += f.magnitude * cos(f.angle);
+        Fy[f.node] += f.magnitude * sin(f.angle);
+    }
+
+    TrussWorkspace ws;
+    if (!solveNumericSections(sym, E.data(), A.data(), Fx.data(), Fy.data(), ws)) {
+        printf("  [GRESKA] Matrica krutosti je singularna — sistem je mehanizam\n\n");
+        return false;
+    }
+
+    printf("\n  --- Staticki proracun (%d DOF, profil %ld clanova) ---\n",
+           sym.nDof, (long)sym.pattern.vals.size());
+    printStaticResults(ws.u, ws.N);
+    return true;
+}
+
+// ─────────────────────────────────────────────
+//  Ispis rezultata (tabele samo za male modele)
+// ─────────────────────────────────────────────
+void printStaticResults(const std::vector<double>& u, const std::vector<double>& N)
+{
+    const int nN = (int)app.nodes.size();
+    const int nE = (int)app.elements.size();
+    const int MAX_ROWS = 50;
+    int    iU = 0, iS = 0;
+    double maxU = 0.0, maxS = 0.0;
+    for (int i = 0; i < nN; i++) {
+        double ui = hypot(u[2*i], u[2*i + 1]);
+        if (ui > maxU) { maxU = ui; iU = i; }
+    }
+    for (int i = 0; i < nE; i++) {
+        double s = fabs(N[i] / sectionOf(app.elements[i]).A);
+        if (s > maxS) { maxS = s; iS = i; }
+    }
+
+    if (nN <= MAX_ROWS) {
+        printf("  cvor   ux [m]          uy [m]\n");
+        for (int i = 0; i < nN; i++)
+            printf("  %-5s  % .6e   % .6e\n", nodeLabel(i).c_str(), u[2*i], u[2*i + 1]);
+    }
+    if (nE <= MAX_ROWS) {
+        printf("  stap   N [N]           sigma [Pa]\n");
+        for (int i = 0; i < nE; i++)
+            printf("  %-5d  % .6e   % .6e\n", i + 1, N[i], N[i] / sectionOf(app.elements[i]).A);
+    }
+    if (nN > 0) printf("  max |u|     = %.6e m  (cvor %s)\n", maxU, nodeLabel(iU).c_str());
+    if (nE > 0) printf("  max |sigma| = %.6e Pa (stap %d)\n", maxS, iS + 1);
+    printf("\n");
+}
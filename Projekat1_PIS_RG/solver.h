@@ -0,0 +1,85 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <vector>
+
+static const double SUPPORT_PENALTY = 1e8;   // kaznena krutost oslonca / najveci dijagonalni clan
+
+// ─────────────────────────────────────────────
+//  Simetricna matrica u skyline (profilnom) formatu
+// ─────────────────────────────────────────────
+// Cuva se gornji trougao po kolonama: kolona j sadrzi redove
+// firstRow[j]..j uzastopno u vals. Choleski faktor U (K = U^T U) ima
+// isti profil, pa se faktorise na mestu.
+struct SkylineMatrix {
+    int                 n = 0;
+    std::vector<int>    firstRow;
+    std::vector<long>   colStart;   // n + 1 elemenata
+    std::vector<double> vals;
+
+    // Profil iz najmanjeg reda po koloni (firstRow[j] <= j)
+    void   setProfile(const std::vector<int>& first);
+    long   index(int i, int j) const { return colStart[j] + (i - firstRow[j]); }  // i <= j
+    void   add(int i, int j, double v);
+    void   clear();
+
+    bool   factorize(int* badDof = nullptr);      // false = singularna
+    void   solve(double* b) const;                // posle factorize()
+    void   multiply(const double* x, double* y) const;  // pre factorize()
+};
+
+// ─────────────────────────────────────────────
+//  Simbolicka faza resetke (zavisi samo od topologije)
+// ─────────────────────────────────────────────
+// Numeracija DOF (RCM po cvorovima), profil matrice i pozicije u koje
+// svaki stap i oslonac upisuju svoje clanove. Jednom napravljena, moze
+// se koristiti za proizvoljno mnogo numerickih resavanja sa drugim
+// E, A i opterecenjima (npr. u parametarskoj analizi).
+struct TrussSymbolic {
+    int nNodes = 0, nElems = 0, nDof = 0;
+    std::vector<int>    dofOfNode;   // prvi DOF cvora (x), y je sledeci
+    std::vector<int>    n1, n2;      // cvorovi stapova
+    std::vector<double> cx, cy, L;   // geometrija stapova
+    std::vector<long>   elemSlot;    // 10 po stapu: gornji trougao 4x4
+    std::vector<int>    secStart;    // nSekcija + 1: stapovi sekcije s su
+    std::vector<int>    secElems;    //   secElems[secStart[s] .. secStart[s+1])
+    std::vector<int>    supNode;     // oslonci razlozeni na pojedinacne veze
+    std::vector<double> supNx, supNy;
+    std::vector<long>   supSlot;     // 3 po vezi: xx, xy, yy
+    SkylineMatrix       pattern;     // samo profil (vals su nule)
+};
+
+// Radni prostor jednog numerickog resavanja (po jedan po niti)
+struct TrussWorkspace {
+    SkylineMatrix       K;
+    std::vector<double> u;     // 2 * nNodes, redosled cvorova iz app
+    std::vector<double> N;     // aksijalne sile stapova [N]
+    std::vector<double> rhs;   // desna strana u numeraciji DOF
+};
+
+bool buildSymbolic(TrussSymbolic& sym);
+
+// Obrnuti Cuthill–McKee redosled cvorova grafa (lista suseda)
+std::vector<int> rcmOrder(const std::vector<std::vector<int>>& adj);
+
+// E, A po stapu; Fx, Fy po cvoru (redosled iz app). Oslonci se uvode
+// kaznenom krutoscu (1e8 * najveci dijagonalni clan).
+bool solveNumeric(const TrussSymbolic& sym,
+                  const double* E, const double* A,
+                  const double* Fx, const double* Fy,
+                  TrussWorkspace& ws);
+
+// Isto, ali E, A po sekciji (app.sections) — sklapanje ide po grupama
+// stapova iste sekcije
+bool solveNumericSections(const TrussSymbolic& sym,
+                          const double* E, const double* A,
+                          const double* Fx, const double* Fy,
+                          TrussWorkspace& ws);
+
+// Staticki proracun trenutnog modela sa ispisom rezultata
+bool solveStatic();
+
+// u: 2 * brojCvorova, N: po stapu (redosled iz app)
+void printStaticResults(const std::vector<double>& u, const std::vector<double>& N);
+
+#endif
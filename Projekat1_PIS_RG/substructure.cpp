@@ -0,0 +1,428 @@
+#include "substructure.h"
+#include "solver.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+
+static const int    TARGET_NODES = 48;     // cvorova po modulu pri automatskoj podeli
+static const double COORD_QUANT  = 1e-6;   // m, tolerancija poredjenja geometrije modula
+
+// Jedan modul: stapovi i cvorovi u kanonskom redosledu (prvo granicni,
+// pa unutrasnji, svaka grupa po relativnim koordinatama)
+struct Module {
+    std::vector<int> elems;
+    std::vector<int> nodes;
+    int              nbNodes = 0;
+    int              type    = -1;
+    std::string      signature;
+};
+
+// Kondenzovane matrice zajednicke za sve module istog potpisa
+struct ModuleType {
+    int rep = 0;                  // modul iz koga je izracunata
+    int nb2 = 0, ni2 = 0;         // granicni / unutrasnji DOF
+    std::vector<double> L;        // Choleski K_ii (donji trougao, ni2 x ni2)
+    std::vector<double> W;        // K_ii^-1 K_ib  (ni2 x nb2)
+    std::vector<double> S;        // K_bb - K_bi W (nb2 x nb2)
+    bool ok = true;
+    int  instances = 0;
+};
+
+// ─────────────────────────────────────────────
+//  Guste rutine (moduli su mali)
+// ─────────────────────────────────────────────
+static bool choleskyDense(std::vector<double>& a, int n)
+{
+    for (int j = 0; j < n; j++) {
+        double* rj = &a[(size_t)j * n];
+        double  d  = rj[j];
+        for (int k = 0; k < j; k++) d -= rj[k] * rj[k];
+        if (!(d > 1e-12 * fabs(rj[j]))) return false;
+        rj[j] = sqrt(d);
+        for (int i = j + 1; i < n; i++) {
+            double* ri = &a[(size_t)i * n];
+            double  s  = ri[j];
+            for (int k = 0; k < j; k++) s -= ri[k] * rj[k];
+            ri[j] = s / rj[j];
+        }
+    }
+    return true;
+}
+
+// L L^T x = b
+static void choleskySolve(const std::vector<double>& L, int n, double* b)
+{
+    for (int i = 0; i < n; i++) {
+        const double* ri = &L[(size_t)i * n];
+        double s = b[i];
+        for (int k = 0; k < i; k++) s -= ri[k] * b[k];
+        b[i] = s / ri[i];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        double s = b[i];
+        for (int k = i + 1; k < n; k++) s -= L[(size_t)k * n + i] * b[k];
+        b[i] = s / L[(size_t)i * n + i];
+    }
+}
+
+// ─────────────────────────────────────────────
+//  Kanonski oblik modula i potpis
+// ─────────────────────────────────────────────
+static void canonicalize(Module& m, const std::vector<char>& iface)
+{
+    std::vector<int>& nd = m.nodes;
+    nd.clear();
+    for (int e : m.elems) {
+        nd.push_back(app.elements[e].n1);
+        nd.push_back(app.elements[e].n2);
+    }
+    std::sort(nd.begin(), nd.end());
+    nd.erase(std::unique(nd.begin(), nd.end()), nd.end());
+
+    float x0 = INFINITY, y0 = INFINITY;
+    for (int n : nd) { x0 = std::min(x0, app.nodes[n].x); y0 = std::min(y0, app.nodes[n].y); }
+    auto qx = [&](int n) { return (long long)llround((app.nodes[n].x - x0) / COORD_QUANT); };
+    auto qy = [&](int n) { return (long long)llround((app.nodes[n].y - y0) / COORD_QUANT); };
+
+    std::sort(nd.begin(), nd.end(), [&](int a, int b) {
+        if (iface[a] != iface[b]) return iface[a] > iface[b];
+        if (qx(a) != qx(b))       return qx(a) < qx(b);
+        return qy(a) < qy(b);
+    });
+    m.nbNodes = 0;
+    for (int n : nd) m.nbNodes += iface[n] ? 1 : 0;
+
+    // Lokalni indeks cvora: pretraga kroz parove (globalni, lokalni)
+    std::vector<std::pair<int, int>> local(nd.size());
+    for (size_t k = 0; k < nd.size(); k++) local[k] = { nd[k], (int)k };
+    std::sort(local.begin(), local.end());
+    auto localOf = [&](int n) {
+        return std::lower_bound(local.begin(), local.end(), std::make_pair(n, -1))->second;
+    };
+
+    struct Key { int a, b, section; };
+    std::vector<Key> keys(m.elems.size());
+    for (size_t k = 0; k < m.elems.size(); k++) {
+        const Element& e = app.elements[m.elems[k]];
+        Key key;
+        key.a = localOf(e.n1);
+        key.b = localOf(e.n2);
+        if (key.a > key.b) std::swap(key.a, key.b);
+        key.section = e.section;
+        keys[k] = key;
+    }
+    std::sort(keys.begin(), keys.end(), [](const Key& p, const Key& q) {
+        if (p.a != q.a) return p.a < q.a;
+        if (p.b != q.b) return p.b < q.b;
+        return p.section < q.section;
+    });
+
+    std::string& s = m.signature;
+    auto put = [&s](const void* p, size_t n) { s.append((const char*)p, n); };
+    int head[2] = { (int)nd.size(), m.nbNodes };
+    put(head, sizeof(head));
+    for (int n : nd) { long long q[2] = { qx(n), qy(n) }; put(q, sizeof(q)); }
+    put(keys.data(), keys.size() * sizeof(Key));
+}
+
+// ─────────────────────────────────────────────
+//  Kondenzacija jednog tipa modula
+// ─────────────────────────────────────────────
+static void condense(const Module& m, ModuleType& t)
+{
+    const int nLoc = (int)m.nodes.size();
+    const int n2   = 2 * nLoc;
+    const int nb2  = 2 * m.nbNodes;
+    const int ni2  = n2 - nb2;
+    t.nb2 = nb2;
+    t.ni2 = ni2;
+
+    std::vector<std::pair<int, int>> local(nLoc);
+    for (int k = 0; k < nLoc; k++) local[k] = { m.nodes[k], k };
+    std::sort(local.begin(), local.end());
+    auto localOf = [&](int n) {
+        return std::lower_bound(local.begin(), local.end(), std::make_pair(n, -1))->second;
+    };
+
+    std::vector<double> K((size_t)n2 * n2, 0.0);
+    for (int e : m.elems) {
+        const Element& el = app.elements[e];
+        double dx = app.nodes[el.n2].x - app.nodes[el.n1].x;
+        double dy = app.nodes[el.n2].y - app.nodes[el.n1].y;
+        double L  = sqrt(dx*dx + dy*dy);
+        double c  = dx / L, s = dy / L, k = (double)sectionOf(el).E * sectionOf(el).A / L;
+        int    d[4] = { 2*localOf(el.n1), 2*localOf(el.n1) + 1,
+                        2*localOf(el.n2), 2*localOf(el.n2) + 1 };
+        double v[4] = { -c, -s, c, s };
+        for (int r = 0; r < 4; r++)
+            for (int q = 0; q < 4; q++)
+                K[(size_t)d[r] * n2 + d[q]] += k * v[r] * v[q];
+    }
+
+    t.L.assign((size_t)ni2 * ni2, 0.0);
+    for (int i = 0; i < ni2; i++)
+        for (int j = 0; j <= i; j++)
+            t.L[(size_t)i * ni2 + j] = K[(size_t)(nb2 + i) * n2 + nb2 + j];
+    if (!choleskyDense(t.L, ni2)) { t.ok = false; return; }
+
+    // W = K_ii^-1 K_ib, kolonu po kolonu
+    t.W.assign((size_t)ni2 * nb2, 0.0);
+    std::vector<double> col(ni2);
+    for (int c = 0; c < nb2; c++) {
+        for (int i = 0; i < ni2; i++) col[i] = K[(size_t)(nb2 + i) * n2 + c];
+        choleskySolve(t.L, ni2, col.data());
+        for (int i = 0; i < ni2; i++) t.W[(size_t)i * nb2 + c] = col[i];
+    }
+
+    t.S.assign((size_t)nb2 * nb2, 0.0);
+    for (int r = 0; r < nb2; r++)
+        for (int c = 0; c < nb2; c++) {
+            double s = K[(size_t)r * n2 + c];
+            for (int i = 0; i < ni2; i++)
+                s -= K[(size_t)(nb2 + i) * n2 + r] * t.W[(size_t)i * nb2 + c];
+            t.S[(size_t)r * nb2 + c] = s;
+        }
+}
+
+// ─────────────────────────────────────────────
+//  solveSubstructured
+// ─────────────────────────────────────────────
+bool solveSubstructured(const SubstructureParams& p)
+{
+    if (!validateModel()) {
+        printf("  [GRESKA] Proracun prekinut — model nije ispravan\n\n");
+        return false;
+    }
+
+    const int nN = (int)app.nodes.size();
+    const int nE = (int)app.elements.size();
+
+    // ── Podela na trake duz duze ose ─────────────────────────────
+    float xMin = INFINITY, xMax = -INFINITY, yMin = INFINITY, yMax = -INFINITY;
+    for (const Node& n : app.nodes) {
+        xMin = std::min(xMin, n.x); xMax = std::max(xMax, n.x);
+        yMin = std::min(yMin, n.y); yMax = std::max(yMax, n.y);
+    }
+    const bool   alongX = (xMax - xMin) >= (yMax - yMin);
+    const double lo     = alongX ? xMin : yMin;
+    const double extent = alongX ? xMax - xMin : yMax - yMin;
+    double width = p.moduleLength;
+    if (!(width > 0.0)) width = std::max(extent * TARGET_NODES / std::max(nN, 1), 1e-3);
+
+    std::vector<long> slab(nE);
+    for (int i = 0; i < nE; i++) {
+        const Element& e = app.elements[i];
+        double c = alongX ? 0.5 * (app.nodes[e.n1].x + app.nodes[e.n2].x)
+                          : 0.5 * (app.nodes[e.n1].y + app.nodes[e.n2].y);
+        slab[i] = (long)floor((c - lo) / width + 1e-6);
+    }
+    std::vector<long> slabIds(slab);
+    std::sort(slabIds.begin(), slabIds.end());
+    slabIds.erase(std::unique(slabIds.begin(), slabIds.end()), slabIds.end());
+
+    const int nMod = (int)slabIds.size();
+    std::vector<Module> mods(nMod);
+    std::vector<int>    modOfElem(nE);
+    for (int i = 0; i < nE; i++) {
+        modOfElem[i] = (int)(std::lower_bound(slabIds.begin(), slabIds.end(), slab[i]) - slabIds.begin());
+        mods[modOfElem[i]].elems.push_back(i);
+    }
+
+    // ── Granicni cvorovi ─────────────────────────────────────────
+    std::vector<int>  owner(nN, -1);
+    std::vector<char> iface(nN, 0);
+    for (int i = 0; i < nE; i++) {
+        int ends[2] = { app.elements[i].n1, app.elements[i].n2 };
+        for (int n : ends) {
+            if (owner[n] < 0)                  owner[n] = modOfElem[i];
+            else if (owner[n] != modOfElem[i]) iface[n] = 1;
+        }
+    }
+    for (const Support& s : app.supports) iface[s.node] = 1;
+    for (int n = 0; n < nN; n++) if (owner[n] < 0) iface[n] = 1;   // cvor bez stapova
+
+    #pragma omp parallel for schedule(dynamic, 16)
+    for (int m = 0; m < nMod; m++)
+        canonicalize(mods[m], iface);
+
+    // ── Jedinstveni tipovi i kondenzacija (paralelno) ────────────
+    std::vector<ModuleType>              types;
+    std::unordered_map<std::string, int> typeOf;
+    for (int m = 0; m < nMod; m++) {
+        auto it = typeOf.find(mods[m].signature);
+        if (it == typeOf.end()) {
+            it = typeOf.emplace(mods[m].signature, (int)types.size()).first;
+            types.emplace_back();
+            types.back().rep = m;
+        }
+        mods[m].type = it->second;
+        types[it->second].instances++;
+        std::string().swap(mods[m].signature);
+    }
+    const int nTypes = (int)types.size();
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (int t = 0; t < nTypes; t++)
+        condense(mods[types[t].rep], types[t]);
+
+    for (int t = 0; t < nTypes; t++)
+        if (!types[t].ok) {
+            const Module& m = mods[types[t].rep];
+            printf("  [GRESKA] Unutrasnjost modula sa stapom %d je labilna "
+                   "(povecajte duzinu modula)\n\n", m.elems[0] + 1);
+            return false;
+        }
+
+    // ── Granicni sistem ──────────────────────────────────────────
+    std::vector<int> ifaceIdx(nN, -1), ifaceNodes;
+    for (int n = 0; n < nN; n++)
+        if (iface[n]) { ifaceIdx[n] = (int)ifaceNodes.size(); ifaceNodes.push_back(n); }
+    const int nI = (int)ifaceNodes.size();
+
+    std::vector<std::vector<int>> adj(nI);
+    for (const Module& m : mods)
+        for (int a = 0; a < m.nbNodes; a++)
+            for (int b = 0; b < m.nbNodes; b++)
+                if (a != b) adj[ifaceIdx[m.nodes[a]]].push_back(ifaceIdx[m.nodes[b]]);
+    for (std::vector<int>& v : adj) {
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+    }
+    std::vector<int> order = rcmOrder(adj);
+    std::vector<int> dofOf(nI);
+    for (int k = 0; k < nI; k++) dofOf[order[k]] = 2 * k;
+    std::vector<std::vector<int>>().swap(adj);
+
+    const int nDof = 2 * nI;
+    std::vector<int> first(nDof);
+    for (int d = 0; d < nDof; d++) first[d] = d & ~1;
+    for (const Module& m : mods) {
+        int lo2 = nDof;
+        for (int a = 0; a < m.nbNodes; a++) lo2 = std::min(lo2, dofOf[ifaceIdx[m.nodes[a]]]);
+        for (int a = 0; a < m.nbNodes; a++) {
+            int d = dofOf[ifaceIdx[m.nodes[a]]];
+            first[d]     = std::min(first[d], lo2);
+            first[d + 1] = std::min(first[d + 1], lo2);
+        }
+    }
+    SkylineMatrix K;
+    K.setProfile(first);
+
+    auto globalDof = [&](const Module& m, int localDof) {
+        return dofOf[ifaceIdx[m.nodes[localDof / 2]]] + (localDof & 1);
+    };
+    for (const Module& m : mods) {
+        const ModuleType& t = types[m.type];
+        for (int r = 0; r < t.nb2; r++) {
+            int gr = globalDof(m, r);
+            for (int c = 0; c < t.nb2; c++) {
+                int gc = globalDof(m, c);
+                if (gr <= gc) K.vals[K.index(gr, gc)] += t.S[(size_t)r * t.nb2 + c];
+            }
+        }
+    }
+
+    double maxDiag = 0.0;
+    for (int d = 0; d < nDof; d++) maxDiag = std::max(maxDiag, K.vals[K.index(d, d)]);
+    const double pen = SUPPORT_PENALTY * (maxDiag > 0.0 ? maxDiag : 1.0);
+    auto addLink = [&](int node, double nx, double ny) {
+        int d = dofOf[ifaceIdx[node]];
+        K.vals[K.index(d, d)]         += pen * nx * nx;
+        K.vals[K.index(d, d + 1)]     += pen * nx * ny;
+        K.vals[K.index(d + 1, d + 1)] += pen * ny * ny;
+    };
+    for (const Support& s : app.supports) {
+        if (s.type == FIXED) { addLink(s.node, 1.0, 0.0); addLink(s.node, 0.0, 1.0); }
+        else                 addLink(s.node, -sin(s.angle), cos(s.angle));
+    }
+
+    if (!K.factorize()) {
+        printf("  [GRESKA] Matrica krutosti je singularna — sistem je mehanizam\n\n");
+        return false;
+    }
+
+    // ── Opterecenje: f_b - W^T f_i po modulu ─────────────────────
+    std::vector<double> F(2 * (size_t)nN, 0.0);
+    for (const Force& f : app.forces) {
+        F[2 * f.node]     += f.magnitude * cos(f.angle);
+        F[2 * f.node + 1] += f.magnitude * sin(f.angle);
+    }
+    auto interiorLoad = [&](const Module& m, int ni2, double* fi) {
+        bool any = false;
+        for (int i = 0; i < ni2; i++) {
+            fi[i] = F[2 * (size_t)m.nodes[m.nbNodes + i / 2] + (i & 1)];
+            any   = any || fi[i] != 0.0;
+        }
+        return any;
+    };
+
+    std::vector<double> b(nDof, 0.0);
+    for (int k = 0; k < nI; k++) {
+        b[dofOf[k]]     = F[2 * (size_t)ifaceNodes[k]];
+        b[dofOf[k] + 1] = F[2 * (size_t)ifaceNodes[k] + 1];
+    }
+    std::vector<int> loaded;
+    for (int m = 0; m < nMod; m++) {
+        const ModuleType& t = types[mods[m].type];
+        std::vector<double> fi(t.ni2);
+        if (!interiorLoad(mods[m], t.ni2, fi.data())) continue;
+        loaded.push_back(m);
+        for (int c = 0; c < t.nb2; c++) {
+            double s = 0.0;
+            for (int i = 0; i < t.ni2; i++) s += t.W[(size_t)i * t.nb2 + c] * fi[i];
+            b[globalDof(mods[m], c)] -= s;
+        }
+    }
+    K.solve(b.data());
+
+    // ── Povratak: u_i = K_ii^-1 f_i - W u_b (paralelno po modulu) ──
+    std::vector<double> u(2 * (size_t)nN, 0.0);
+    for (int k = 0; k < nI; k++) {
+        u[2 * (size_t)ifaceNodes[k]]     = b[dofOf[k]];
+        u[2 * (size_t)ifaceNodes[k] + 1] = b[dofOf[k] + 1];
+    }
+    #pragma omp parallel
+    {
+        std::vector<double> ub, fi;
+        #pragma omp for schedule(dynamic, 64)
+        for (int m = 0; m < nMod; m++) {
+            const Module&     mod = mods[m];
+            const ModuleType& t   = types[mod.type];
+            ub.resize(t.nb2);
+            fi.assign(t.ni2, 0.0);
+            for (int c = 0; c < t.nb2; c++) ub[c] = b[globalDof(mod, c)];
+            if (std::binary_search(loaded.begin(), loaded.end(), m)) {
+                interiorLoad(mod, t.ni2, fi.data());
+                choleskySolve(t.L, t.ni2, fi.data());
+            }
+            for (int i = 0; i < t.ni2; i++) {
+                double s = fi[i];
+                for (int c = 0; c < t.nb2; c++) s -= t.W[(size_t)i * t.nb2 + c] * ub[c];
+                u[2 * (size_t)mod.nodes[mod.nbNodes + i / 2] + (i & 1)] = s;
+            }
+        }
+    }
+
+    std::vector<double> N(nE);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < nE; i++) {
+        const Element& e = app.elements[i];
+        double dx = app.nodes[e.n2].x - app.nodes[e.n1].x;
+        double dy = app.nodes[e.n2].y - app.nodes[e.n1].y;
+        double L  = sqrt(dx*dx + dy*dy);
+        double du = ((u[2*e.n2] - u[2*e.n1]) * dx + (u[2*e.n2 + 1] - u[2*e.n1 + 1]) * dy) / L;
+        N[i] = (double)sectionOf(e).E * sectionOf(e).A / L * du;
+    }
+
+    printf("\n  --- Staticki proracun podstrukturama ---\n");
+    printf("  Modula: %d (razlicitih: %d), duzina modula %.3f m\n", nMod, nTypes, width);
+    printf("  Granicnih DOF: %d od %d, profil %ld clanova\n",
+           nDof, 2 * nN, (long)K.vals.size());
+    printStaticResults(u, N);
+    return true;
+}
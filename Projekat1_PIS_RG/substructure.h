@@ -0,0 +1,22 @@
+#ifndef SUBSTRUCTURE_H
+#define SUBSTRUCTURE_H
+
+// ─────────────────────────────────────────────
+//  Staticki proracun podstrukturama (kondenzacija na granice modula)
+// ─────────────────────────────────────────────
+struct SubstructureParams {
+    // Model se sece na trake ove duzine duz duze ose (stap pripada traci
+    // svog sredista). Za lance jednakih polja zadati duzinu polja (ili
+    // njen umnozak) — tada su moduli identicni i kondenzuju se samo jednom.
+    double moduleLength = 0.0;   // m, 0 = automatski (~TARGET_NODES cvorova po modulu)
+};
+
+// Cvor je granicni ako ga dele stapovi iz vise modula ili ima oslonac.
+// Svaki modul se kondenzuje na granicne DOF (Schur-ov komplement
+// S = K_bb - K_bi K_ii^-1 K_ib); moduli sa istim potpisom (geometrija
+// pomerena u koordinatni pocetak, sekcije, granicni cvorovi) dele jedan
+// komplement. Granicni sistem se resava skyline Choleskim, a
+// unutrasnja pomeranja se vracaju paralelno po modulima.
+bool solveSubstructured(const SubstructureParams& p);
+
+#endif
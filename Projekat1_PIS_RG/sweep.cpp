@@ -0,0 +1,281 @@
+#include "sweep.h"
+#include "solver.h"
+#include "utils.h"
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// ─────────────────────────────────────────────
+//  Statistika u hodu
+// ─────────────────────────────────────────────
+// Welford za srednju vrednost i disperziju; dve statistike (dve niti) se
+// spajaju Chan-ovom formulom.
+struct RunningStat {
+    long   n    = 0;
+    double mean = 0.0, m2 = 0.0;
+    double lo   = INFINITY, hi = -INFINITY;
+
+    void add(double x)
+    {
+        n++;
+        double d = x - mean;
+        mean += d / n;
+        m2   += d * (x - mean);
+        lo = std::min(lo, x);
+        hi = std::max(hi, x);
+    }
+    void merge(const RunningStat& o)
+    {
+        if (o.n == 0) return;
+        long   nn = n + o.n;
+        double d  = o.mean - mean;
+        mean += d * o.n / nn;
+        m2   += o.m2 + d * d * (double)n * o.n / nn;
+        n     = nn;
+        lo = std::min(lo, o.lo);
+        hi = std::max(hi, o.hi);
+    }
+    double stddev() const { return (n > 1) ? sqrt(m2 / (n - 1)) : 0.0; }
+};
+
+// Histogram sa logaritamskim binovima od 1e-15 do 1e15 (relativna
+// rezolucija ~0.8 %). Stalna memorija, spaja se sabiranjem, a kvantili
+// se citaju interpolacijom unutar bina.
+struct LogHistogram {
+    static const int BINS = 8192;
+    static constexpr double LO = -15.0, HI = 15.0;
+
+    std::vector<long> count = std::vector<long>(BINS, 0);
+    long zeros = 0, total = 0;
+
+    void add(double x)
+    {
+        total++;
+        if (!(x > 0.0)) { zeros++; return; }
+        double b = (log10(x) - LO) / (HI - LO) * BINS;
+        int    i = (int)std::min(std::max(b, 0.0), (double)BINS - 1);
+        count[i]++;
+    }
+    void merge(const LogHistogram& o)
+    {
+        for (int i = 0; i < BINS; i++) count[i] += o.count[i];
+        zeros += o.zeros;
+        total += o.total;
+    }
+    double quantile(double q) const
+    {
+        if (total == 0) return 0.0;
+        double target = q * total;
+        double acc    = zeros;
+        if (acc >= target) return 0.0;
+        for (int i = 0; i < BINS; i++) {
+            if (acc + count[i] >= target) {
+                double w = (count[i] > 0) ? (target - acc) / count[i] : 0.0;
+                return pow(10.0, LO + (i + w) * (HI - LO) / BINS);
+            }
+            acc += count[i];
+        }
+        return pow(10.0, HI);
+    }
+};
+
+// Rezultati jedne niti
+struct SweepStats {
+    RunningStat  maxU, maxS;
+    LogHistogram histU, histS;
+    long         failures = 0, singular = 0;
+    // Po stapu: aksijalna sila (Welford sa zajednickim brojem uzoraka)
+    long                n = 0;
+    std::vector<double> meanN, m2N;
+
+    void init(int nE) { meanN.assign(nE, 0.0); m2N.assign(nE, 0.0); }
+
+    void addMembers(const std::vector<double>& N)
+    {
+        n++;
+        const double inv = 1.0 / n;
+        for (size_t i = 0; i < N.size(); i++) {
+            double d = N[i] - meanN[i];
+            meanN[i] += d * inv;
+            m2N[i]   += d * (N[i] - meanN[i]);
+        }
+    }
+
+    void merge(const SweepStats& o)
+    {
+        maxU.merge(o.maxU);
+        maxS.merge(o.maxS);
+        histU.merge(o.histU);
+        histS.merge(o.histS);
+        failures += o.failures;
+        singular += o.singular;
+        if (o.n == 0) return;
+        long nn = n + o.n;
+        for (size_t i = 0; i < meanN.size(); i++) {
+            double d = o.meanN[i] - meanN[i];
+            meanN[i] += d * o.n / nn;
+            m2N[i]   += o.m2N[i] + d * d * (double)n * o.n / nn;
+        }
+        n = nn;
+    }
+};
+
+// Seme uzorka zavisi samo od (seed, indeks) — rezultat ne zavisi od broja niti
+static uint64_t splitmix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// ─────────────────────────────────────────────
+//  runSweep
+// ─────────────────────────────────────────────
+bool runSweep(const SweepParams& p)
+{
+    if (!validateModel()) {
+        printf("  [GRESKA] Analiza prekinuta — model nije ispravan\n\n");
+        return false;
+    }
+
+    const int nN = (int)app.nodes.size();
+    const int nE = (int)app.elements.size();
+    const int nF = (int)app.forces.size();
+    const int nS = (int)app.sections.size();
+
+    TrussSymbolic sym;
+    buildSymbolic(sym);
+
+    const int  levels   = std::max(p.gridLevels, 1);
+    const long nSamples = (p.mode == SWEEP_GRID) ? (long)levels * levels * levels
+                                                 : (long)std::max(p.samples, 1);
+    const double sigE = sqrt(log(1.0 + p.covE * p.covE));
+    const double sigA = sqrt(log(1.0 + p.covA * p.covA));
+    const double spread = p.angleSpreadDeg * M_PI / 180.0;
+
+    SweepStats total;
+    total.init(nE);
+    int nThreads = 1;
+
+    printf("  %s: %ld uzoraka, %d DOF\n",
+           (p.mode == SWEEP_GRID) ? "Parametarska mreza" : "Monte Carlo", nSamples, sym.nDof);
+
+    #pragma omp parallel
+    {
+        // Radni prostor i statistika po niti
+        TrussWorkspace ws;
+        SweepStats     local;
+        local.init(nE);
+        std::vector<double> E(nE), A(nE), Fx(nN), Fy(nN);
+        std::vector<double> Es(nS), As(nS);   // po sekciji (mreza)
+
+        #pragma omp for schedule(dynamic, 4)
+        for (long s = 0; s < nSamples; s++) {
+            std::fill(Fx.begin(), Fx.end(), 0.0);
+            std::fill(Fy.begin(), Fy.end(), 0.0);
+
+            if (p.mode == SWEEP_GRID) {
+                long   iE = s % levels, iA = (s / levels) % levels, iF = s / (levels * levels);
+                double step = (levels > 1) ? 2.0 * p.gridRange / (levels - 1) : 0.0;
+                double fE = 1.0 - p.gridRange + iE * step;
+                double fA = 1.0 - p.gridRange + iA * step;
+                double fF = 1.0 - p.gridRange + iF * step;
+                if (levels == 1) fE = fA = fF = 1.0;
+                // Isti faktor za sve stapove → dovoljno je skalirati sekcije
+                for (int k = 0; k < nS; k++) {
+                    Es[k] = app.sections[k].E * fE;
+                    As[k] = app.sections[k].A * fA;
+                }
+                for (int i = 0; i < nE; i++) A[i] = As[app.elements[i].section];
+                for (const Force& f : app.forces) {
+                    Fx[f.node] += fF * f.magnitude * cos(f.angle);
+                    Fy[f.node] += fF * f.magnitude * sin(f.angle);
+                }
+            } else {
+                std::mt19937_64 rng(splitmix64(p.seed ^ splitmix64((uint64_t)s)));
+                std::normal_distribution<double>       z(0.0, 1.0);
+                std::uniform_real_distribution<double> uni(-spread, spread);
+                // Lognormalni faktor sa srednjom vrednoscu 1
+                for (int i = 0; i < nE; i++) {
+                    const Section& sec = sectionOf(app.elements[i]);
+                    E[i] = sec.E * exp(sigE * z(rng) - 0.5 * sigE * sigE);
+                    A[i] = sec.A * exp(sigA * z(rng) - 0.5 * sigA * sigA);
+                }
+                for (int k = 0; k < nF; k++) {
+                    const Force& f = app.forces[k];
+                    double F = f.magnitude * (1.0 + p.covF * z(rng));
+                    double a = f.angle + (spread > 0.0 ? uni(rng) : 0.0);
+                    Fx[f.node] += F * cos(a);
+                    Fy[f.node] += F * sin(a);
+                }
+            }
+
+            bool ok = (p.mode == SWEEP_GRID)
+                    ? solveNumericSections(sym, Es.data(), As.data(), Fx.data(), Fy.data(), ws)
+                    : solveNumeric(sym, E.data(), A.data(), Fx.data(), Fy.data(), ws);
+            if (!ok) {
+                local.singular++;
+                local.failures++;
+                continue;
+            }
+
+            double mu = 0.0, ms = 0.0;
+            for (int i = 0; i < nN; i++)
+                mu = std::max(mu, hypot(ws.u[2*i], ws.u[2*i + 1]));
+            for (int i = 0; i < nE; i++)
+                ms = std::max(ms, fabs(ws.N[i] / A[i]));
+
+            local.maxU.add(mu);
+            local.maxS.add(ms);
+            local.histU.add(mu);
+            local.histS.add(ms);
+            local.addMembers(ws.N);
+            if ((p.sigmaAllow > 0.0 && ms > p.sigmaAllow) ||
+                (p.uAllow     > 0.0 && mu > p.uAllow))
+                local.failures++;
+        }
+
+        #pragma omp critical
+        total.merge(local);
+
+#ifdef _OPENMP
+        #pragma omp single
+        nThreads = omp_get_num_threads();
+#endif
+    }
+
+    // ── Izvestaj ─────────────────────────────────────────────
+    printf("  Niti: %d, uspesnih resavanja: %ld, singularnih: %ld\n",
+           nThreads, total.maxU.n, total.singular);
+    if (total.maxU.n > 0) {
+        printf("                 srednja       std           5%%            50%%           95%%\n");
+        printf("  max |u| [m]    %.4e    %.4e    %.4e    %.4e    %.4e\n",
+               total.maxU.mean, total.maxU.stddev(),
+               total.histU.quantile(0.05), total.histU.quantile(0.50), total.histU.quantile(0.95));
+        printf("  max |s| [Pa]   %.4e    %.4e    %.4e    %.4e    %.4e\n",
+               total.maxS.mean, total.maxS.stddev(),
+               total.histS.quantile(0.05), total.histS.quantile(0.50), total.histS.quantile(0.95));
+    }
+    printf("  Verovatnoca otkaza: %.6f  (%ld / %ld)\n",
+           (double)total.failures / nSamples, total.failures, nSamples);
+
+    FILE* f = fopen(p.outPath, "w");
+    if (!f) {
+        printf("  [GRESKA] Nije moguce otvoriti %s za pisanje!\n\n", p.outPath);
+        return false;
+    }
+    fprintf(f, "# br   N_srednje [N]    N_std [N]\n");
+    for (int i = 0; i < nE; i++)
+        fprintf(f, "%d      %.6e    %.6e\n", i + 1, total.meanN[i],
+                (total.n > 1) ? sqrt(total.m2N[i] / (total.n - 1)) : 0.0);
+    fclose(f);
+    printf("  [OK] Statistika po stapovima upisana u %s\n\n", p.outPath);
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+// ─────────────────────────────────────────────
+//  Monte Carlo / parametarska analiza
+// ─────────────────────────────────────────────
+enum SweepMode {
+    SWEEP_MONTE_CARLO,   // slucajni uzorci
+    SWEEP_GRID           // pravilna mreza faktora E x A x F
+};
+
+struct SweepParams {
+    SweepMode mode = SWEEP_MONTE_CARLO;
+
+    // Monte Carlo: E i A lognormalno po stapu, |F| normalno po sili,
+    // ugao sile uniformno u +-angleSpreadDeg
+    int      samples        = 1000;
+    double   covE           = 0.05;
+    double   covA           = 0.03;
+    double   covF           = 0.10;
+    double   angleSpreadDeg = 0.0;
+    unsigned seed           = 12345;
+
+    // Mreza: gridLevels faktora u [1 - gridRange, 1 + gridRange] za svaki
+    // od E, A i |F| (ukupno gridLevels^3 uzoraka)
+    int    gridLevels = 5;
+    double gridRange  = 0.10;
+
+    // Otkaz: max |sigma| > sigmaAllow ili max |u| > uAllow (0 = ne proverava se)
+    double sigmaAllow = 235e6;   // Pa
+    double uAllow     = 0.0;     // m
+
+    const char* outPath = "MKE-2D.mc";   // statistika po stapu
+};
+
+// Simbolicka faza se pravi jednom; uzorci se resavaju paralelno, svaka nit
+// sa svojim radnim prostorom. Statistika se racuna u hodu (srednja
+// vrednost, disperzija, kvantili iz histograma), bez cuvanja rezultata.
+bool runSweep(const SweepParams& p);
+
+#endif
@@ -1,4 +1,6 @@
 #include "utils.h"
+#include <cstring>
+#include <unordered_map>
 
 AppState app;
 
@@ -26,3 +28,93 @@ int findClosestNode(float x, float y)
     }
     return -1;
 }
+
+// ─────────────────────────────────────────────
+//  Tabela sekcija
+// ─────────────────────────────────────────────
+// Indeks (E, A, rho) → sekcija. Gradi se ponovo tek kad tabela naraste
+// mimo findOrAddSection ili posle sectionsChanged(); pri duplikatima
+// vazi prva sekcija, kao i ranije.
+struct SectionKey {
+    uint32_t E, A, rho;   // bitovi float vrednosti
+    bool operator==(const SectionKey& o) const { return E == o.E && A == o.A && rho == o.rho; }
+};
+
+struct SectionKeyHash {
+    size_t operator()(const SectionKey& k) const
+    {
+        uint64_t h = ((uint64_t)k.E << 32 | k.A) * 0x9E3779B97F4A7C15ull;
+        return (size_t)((h ^ (h >> 29) ^ k.rho) * 0xBF58476D1CE4E5B9ull >> 16);
+    }
+};
+
+static std::unordered_map<SectionKey, int, SectionKeyHash> sectionIndex;
+static size_t indexedSections = 0;   // koliko sekcija indeks pokriva
+static bool   indexValid      = false;
+
+static SectionKey sectionKey(float E, float A, float rho)
+{
+    SectionKey k;
+    memcpy(&k.E, &E, 4);
+    memcpy(&k.A, &A, 4);
+    memcpy(&k.rho, &rho, 4);
+    return k;
+}
+
+void sectionsChanged()
+{
+    indexValid = false;
+}
+
+int findOrAddSection(float E, float A, float rho)
+{
+    if (!indexValid || indexedSections != app.sections.size()) {
+        sectionIndex.clear();
+        for (int i = 0; i < (int)app.sections.size(); i++) {
+            const Section& s = app.sections[i];
+            sectionIndex.emplace(sectionKey(s.E, s.A, s.rho), i);
+        }
+        indexedSections = app.sections.size();
+        indexValid      = true;
+    }
+
+    SectionKey key = sectionKey(E, A, rho);
+    auto it = sectionIndex.find(key);
+    if (it != sectionIndex.end())
+        return it->second;
+    if ((int)app.sections.size() >= MAX_SECTIONS)
+        return -1;
+    app.sections.push_back({ E, A, rho });
+    int id = (int)app.sections.size() - 1;
+    sectionIndex.emplace(key, id);
+    indexedSections = app.sections.size();
+    return id;
+}
+
+// Jedan prolaz kroz stapove: oznaci koriscene, prenumerisi ih redom
+int compactSections()
+{
+    const size_t nS = app.sections.size();
+    if (nS == 0) return 0;
+    std::vector<int> remap(nS, -1);
+    remap[0] = 0;                                      // sekcija 0 uvek postoji
+    if (app.currentSection < nS) remap[app.currentSection] = 0;
+    for (const Element& e : app.elements) remap[e.section] = 0;
+
+    int kept = 0;
+    for (size_t i = 0; i < nS; i++) {
+        if (remap[i] < 0) continue;
+        remap[i] = kept;
+        app.sections[kept++] = app.sections[i];
+    }
+    int removed = (int)nS - kept;
+    if (removed == 0) return 0;
+
+    app.sections.resize(kept);
+    for (Element& e : app.elements) e.section = (uint16_t)remap[e.section];
+    app.currentSection = (app.currentSection < nS) ? (uint16_t)remap[app.currentSection] : 0;
+    sectionsChanged();
+    markDirty(ARR_SECTIONS, 0);
+    markDirty(ARR_ELEMENTS, 0);
+    return removed;
+}
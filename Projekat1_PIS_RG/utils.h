@@ -3,16 +3,26 @@
 
 #include <vector>
 #include <cmath>
+#include <cstdint>
 #include <string>
 
 struct Node {
     float x, y;
 };
 
-struct Element {
-    int   n1, n2;
+// Poprecni presek + materijal; stapovi ga referenciraju indeksom, pa se
+// izmena jedne sekcije odmah odnosi na sve njene stapove
+struct Section {
     float E;   // Pa (unosi se u GPa, konvertuje se)
     float A;   // m2 (unosi se u cm2, konvertuje se)
+    float rho; // kg/m3 (za dinamicku analizu)
+};
+
+static const int MAX_SECTIONS = 65536;
+
+struct Element {
+    int      n1, n2;
+    uint16_t section;   // indeks u app.sections
 };
 
 enum SupportType {
@@ -32,6 +42,15 @@ struct Force {
     float angle;     // radijani, visekatnik PI/4
 };
 
+// Sila promenljiva u vremenu: F(t) je deo-po-deo linearna kroz tacke
+// (t[i], F[i]); pre prve tacke F = F[0], posle poslednje F = F[n-1].
+struct TimeLoad {
+    int                node;
+    float              angle;  // radijani, visekatnik PI/4
+    std::vector<float> t;      // s (rastuce)
+    std::vector<float> F;      // N
+};
+
 enum Mode {
     MODE_DRAW,
     MODE_FORCE,
@@ -40,17 +59,19 @@ enum Mode {
 };
 
 struct AppState {
-    std::vector<Node>    nodes;
-    std::vector<Element> elements;
-    std::vector<Support> supports;
-    std::vector<Force>   forces;
+    std::vector<Node>     nodes;
+    std::vector<Element>  elements;
+    std::vector<Support>  supports;
+    std::vector<Force>    forces;
+    std::vector<TimeLoad> timeLoads;
+
+    // Biblioteka sekcija; sekcija 0 uvek postoji
+    std::vector<Section>  sections = { { 210e9f, 1e-3f, 7850.0f } };
 
     Mode mode = MODE_DRAW;
 
-    // Podrazumevane vrednosti za nove stapove
-    // (azuriraju se nakon svakog terminalnog unosa)
-    float currentE = 210e9f;  // Pa
-    float currentA = 1e-3f;   // m2
+    // Sekcija za nove stapove (azurira se nakon svakog terminalnog unosa)
+    uint16_t currentSection = 0;
 
     // Oslonac
     SupportType currentSupportType  = FIXED;
@@ -62,10 +83,35 @@ struct AppState {
 
 extern AppState app;
 
+// ── Izmene modela od poslednjeg snimka (autosave.cpp) ─────────
+// Dodavanje na kraj niza se prepoznaje po duzini; izmena postojecih
+// zapisa i brisanje iz sredine moraju da se obeleze na mestu izmene.
+enum ModelArray {
+    ARR_NODES, ARR_ELEMENTS, ARR_SUPPORTS, ARR_FORCES, ARR_TIMELOADS, ARR_SECTIONS,
+    ARR_COUNT
+};
+
+// Zapisi [first, last) su izmenjeni; bez last — svi od first do kraja
+void markDirty(ModelArray a, size_t first, size_t last = SIZE_MAX);
+void markAllDirty();
+
 float snapToGrid(float v);
 float snapAngle(float angle);
 int   findClosestNode(float x, float y);
 
+// Postojeca sekcija sa tacno ovim vrednostima ili nova; -1 ako je tabela puna
+int   findOrAddSection(float E, float A, float rho);
+// Posle izmene vrednosti postojece sekcije ili zamene cele tabele
+void  sectionsChanged();
+// Izbacuje sekcije koje ne koristi nijedan stap (osim 0 i trenutne) i
+// prenumerise stapove; vraca broj izbacenih. Indeksi sekcija se menjaju.
+int   compactSections();
+inline const Section& sectionOf(const Element& e) { return app.sections[e.section]; }
+
 void saveToFile();
+bool validateModel();
+
+bool saveCompact(const char* path);
+bool loadCompact(const char* path);
 
 #endif
@@ -0,0 +1,285 @@
+#include "utils.h"
+#include "crossings.h"
+#include <cstdio>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+
+// ─────────────────────────────────────────────
+//  Provera strukture pre izvoza / proracuna
+// ─────────────────────────────────────────────
+// Provere su linearne po broju cvorova, stapova i oslonaca:
+//   - prebrojavanje 2j  vs  m + r  (FIXED = 2 veze, ROLLER = 1 veza)
+//   - povezane komponente (union-find sa kompresijom puta)
+//   - krute pomeranja svake komponente (rang sistema veza oslonaca)
+//   - stapovi nulte duzine i duplirani stapovi
+// osim preseka stapova (brisuca prava, O((n + k) log n)).
+// Ovo su nuzni uslovi — unutrasnji mehanizmi (npr. cetvorougao bez
+// dijagonale) se otkrivaju tek singularnoscu matrice krutosti.
+
+static const int MAX_ISPIS = 10;  // koliko primera svake greske ispisati
+
+static std::string nodeLabel(int i)
+{
+    std::string s;
+    do {
+        s = (char)('A' + (i % 26)) + s;
+        i = i / 26 - 1;
+    } while (i >= 0);
+    return s;
+}
+
+static int findRoot(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];  // polovljenje puta
+        i = parent[i];
+    }
+    return i;
+}
+
+static void unite(std::vector<int>& parent, std::vector<int>& rank, int a, int b)
+{
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a == b) return;
+    if (rank[a] < rank[b]) { int t = a; a = b; b = t; }
+    parent[b] = a;
+    if (rank[a] == rank[b]) rank[a]++;
+}
+
+// Rang simetricne pozitivno semidefinitne 3x3 matrice (Gausova eliminacija
+// sa pivotiranjem). Prag je relativan prema najvecem dijagonalnom clanu.
+static int rank3(double G[3][3])
+{
+    double maxDiag = std::max(G[0][0], std::max(G[1][1], G[2][2]));
+    const double tol = 1e-9 * maxDiag;
+
+    int r = 0;
+    bool used[3] = { false, false, false };
+    for (int c = 0; c < 3; c++) {
+        int    piv  = -1;
+        double best = tol;
+        for (int i = 0; i < 3; i++)
+            if (!used[i] && fabs(G[i][c]) > best) { best = fabs(G[i][c]); piv = i; }
+        if (piv < 0) continue;
+        used[piv] = true;
+        r++;
+        for (int i = 0; i < 3; i++) {
+            if (i == piv) continue;
+            double k = G[i][c] / G[piv][c];
+            for (int j = 0; j < 3; j++) G[i][j] -= k * G[piv][j];
+        }
+    }
+    return r;
+}
+
+bool validateModel()
+{
+    const int nN = (int)app.nodes.size();
+    const int nE = (int)app.elements.size();
+    int errors = 0;
+
+    printf("\n  --- Provera modela ---\n");
+
+    if (nN == 0) {
+        printf("  [GRESKA] Model nema cvorova.\n");
+        return false;
+    }
+
+    // ── Stapovi nulte duzine (nezavisno po stapu → paralelno) ────
+    std::vector<char> zeroLen(nE, 0);
+    int nZero = 0;
+    #pragma omp parallel for reduction(+:nZero) schedule(static)
+    for (int i = 0; i < nE; i++) {
+        const Element& e = app.elements[i];
+        bool z = (e.n1 == e.n2);
+        if (!z) {
+            float dx = app.nodes[e.n2].x - app.nodes[e.n1].x;
+            float dy = app.nodes[e.n2].y - app.nodes[e.n1].y;
+            z = (dx*dx + dy*dy) < 1e-12f;
+        }
+        zeroLen[i] = z;
+        nZero += z;
+    }
+    if (nZero > 0) {
+        printf("  [GRESKA] Stapova nulte duzine: %d\n", nZero);
+        for (int i = 0, k = 0; i < nE && k < MAX_ISPIS; i++)
+            if (zeroLen[i]) {
+                printf("            stap %d (%s-%s)\n", i + 1,
+                       nodeLabel(app.elements[i].n1).c_str(),
+                       nodeLabel(app.elements[i].n2).c_str());
+                k++;
+            }
+        errors += nZero;
+    }
+
+    // ── Duplirani stapovi (isti par cvorova, bez obzira na smer) ─
+    {
+        std::unordered_set<uint64_t> seen;
+        seen.reserve(nE * 2);
+        int nDup = 0;
+        for (int i = 0; i < nE; i++) {
+            uint32_t a = (uint32_t)app.elements[i].n1;
+            uint32_t b = (uint32_t)app.elements[i].n2;
+            if (a > b) { uint32_t t = a; a = b; b = t; }
+            if (!seen.insert(((uint64_t)a << 32) | b).second) {
+                if (nDup < MAX_ISPIS)
+                    printf("  [GRESKA] Stap %d (%s-%s) je dupliran\n", i + 1,
+                           nodeLabel((int)a).c_str(), nodeLabel((int)b).c_str());
+                nDup++;
+            }
+        }
+        if (nDup > MAX_ISPIS)
+            printf("  [GRESKA] ... ukupno dupliranih stapova: %d\n", nDup);
+        errors += nDup;
+    }
+
+    // ── Preseci i preklapanja stapova ────────────────────────────
+    // Cvor na tudjem stapu i kolinearno preklapanje su greske (stap nije
+    // vezan u tom cvoru). Presek bez cvora je samo upozorenje: nevezane
+    // ukrstene dijagonale mogu biti namerne.
+    {
+        std::vector<Crossing> found;
+        findCrossings(found);
+        int nBad = 0, nProper = 0;
+        for (const Crossing& c : found) {
+            const Element& a = app.elements[c.a];
+            const Element& b = app.elements[c.b];
+            if (c.kind == CROSS_PROPER) {
+                if (nProper < MAX_ISPIS)
+                    printf("  [UPOZORENJE] Stapovi %d (%s-%s) i %d (%s-%s) se seku bez cvora "
+                           "u (%.3f, %.3f)\n", c.a + 1,
+                           nodeLabel(a.n1).c_str(), nodeLabel(a.n2).c_str(), c.b + 1,
+                           nodeLabel(b.n1).c_str(), nodeLabel(b.n2).c_str(), c.x, c.y);
+                nProper++;
+            } else {
+                if (nBad < MAX_ISPIS) {
+                    if (c.kind == CROSS_OVERLAP)
+                        printf("  [GRESKA] Stapovi %d (%s-%s) i %d (%s-%s) se preklapaju\n",
+                               c.a + 1, nodeLabel(a.n1).c_str(), nodeLabel(a.n2).c_str(),
+                               c.b + 1, nodeLabel(b.n1).c_str(), nodeLabel(b.n2).c_str());
+                    else if (c.node >= 0)
+                        printf("  [GRESKA] Cvor %s lezi na stapu %d (%s-%s) a nije vezan\n",
+                               nodeLabel(c.node).c_str(), c.a + 1,
+                               nodeLabel(a.n1).c_str(), nodeLabel(a.n2).c_str());
+                    else
+                        printf("  [GRESKA] Stapovi %d i %d imaju razlicite cvorove u istoj "
+                               "tacki (%.3f, %.3f)\n", c.a + 1, c.b + 1, c.x, c.y);
+                }
+                nBad++;
+            }
+        }
+        if (nProper > MAX_ISPIS)
+            printf("  [UPOZORENJE] ... ukupno preseka bez cvora: %d\n", nProper);
+        if (nBad > MAX_ISPIS)
+            printf("  [GRESKA] ... ukupno dodira / preklapanja: %d\n", nBad);
+        if (!found.empty())
+            printf("  [INFO] Taster C prikazuje preseke i nudi podelu stapova\n");
+        errors += nBad;
+    }
+
+    // ── Prebrojavanje: 2j  vs  m + r ─────────────────────────────
+    int r = 0;
+    for (const Support& s : app.supports)
+        r += (s.type == FIXED) ? 2 : 1;
+
+    int dof = 2 * nN;
+    printf("  2j = %d,  m + r = %d + %d = %d\n", dof, nE, r, nE + r);
+    if (nE + r < dof) {
+        printf("  [GRESKA] m + r < 2j — sistem je mehanizam (nedostaje %d veza)\n",
+               dof - (nE + r));
+        errors++;
+    } else if (nE + r > dof) {
+        printf("  [INFO] Sistem je %d puta staticki neodredjen\n", nE + r - dof);
+    } else {
+        printf("  [INFO] Sistem je staticki odredjen (ako nije mehanizam)\n");
+    }
+
+    // ── Povezane komponente ──────────────────────────────────────
+    std::vector<int> parent(nN), rnk(nN, 0);
+    for (int i = 0; i < nN; i++) parent[i] = i;
+    for (int i = 0; i < nE; i++)
+        unite(parent, rnk, app.elements[i].n1, app.elements[i].n2);
+
+    std::vector<int> compOf(nN), compRep;   // indeks komponente za svaki cvor
+    std::vector<int> compIdx(nN, -1);
+    for (int i = 0; i < nN; i++) {
+        int root = findRoot(parent, i);
+        if (compIdx[root] < 0) {
+            compIdx[root] = (int)compRep.size();
+            compRep.push_back(i);
+        }
+        compOf[i] = compIdx[root];
+    }
+    int nComp = (int)compRep.size();
+    if (nComp > 1)
+        printf("  [UPOZORENJE] Model se sastoji iz %d nepovezanih delova\n", nComp);
+
+    // ── Krute pomeranja po komponenti ────────────────────────────
+    // Svaka veza oslonca je vektor (dx, dy, moment oko referentnog cvora);
+    // komponenta je kinematicki stabilna samo ako je rang sistema veza 3.
+    // Moment se deli velicinom komponente da bi sve tri koordinate bile
+    // bezdimenzione — inace dugacki rasponi ili sum zaokruzivanja ugla
+    // (cos 270° != 0 u float) menjaju rang.
+    std::vector<float> bx0(nComp, INFINITY), bx1(nComp, -INFINITY);
+    std::vector<float> by0(nComp, INFINITY), by1(nComp, -INFINITY);
+    for (int i = 0; i < nN; i++) {
+        int c = compOf[i];
+        bx0[c] = std::min(bx0[c], app.nodes[i].x); bx1[c] = std::max(bx1[c], app.nodes[i].x);
+        by0[c] = std::min(by0[c], app.nodes[i].y); by1[c] = std::max(by1[c], app.nodes[i].y);
+    }
+    std::vector<double> gram(9 * (size_t)nComp, 0.0);
+    auto addRestraint = [&](int c, double x, double y, double dx, double dy) {
+        double Lc   = std::max((double)std::max(bx1[c] - bx0[c], by1[c] - by0[c]), 1e-6);
+        double v[3] = { dx, dy, (x*dy - y*dx) / Lc };
+        double* G = &gram[9 * (size_t)c];
+        for (int a = 0; a < 3; a++)
+            for (int b = 0; b < 3; b++)
+                G[3*a + b] += v[a] * v[b];
+    };
+    for (const Support& s : app.supports) {
+        int    c  = compOf[s.node];
+        double x  = app.nodes[s.node].x - app.nodes[compRep[c]].x;
+        double y  = app.nodes[s.node].y - app.nodes[compRep[c]].y;
+        if (s.type == FIXED) {
+            addRestraint(c, x, y, 1.0, 0.0);
+            addRestraint(c, x, y, 0.0, 1.0);
+        } else {
+            // Pokretni oslonac prenosi samo silu upravnu na podlogu
+            addRestraint(c, x, y, -sin(s.angle), cos(s.angle));
+        }
+    }
+
+    // Komponenta od jednog cvora ima samo 2 translacije
+    std::vector<int> compSize(nComp, 0);
+    for (int i = 0; i < nN; i++) compSize[compOf[i]]++;
+
+    int nLabile = 0;
+    for (int c = 0; c < nComp; c++) {
+        double G[3][3];
+        for (int a = 0; a < 3; a++)
+            for (int b = 0; b < 3; b++)
+                G[a][b] = gram[9*(size_t)c + 3*a + b];
+        int need = (compSize[c] == 1) ? 2 : 3;
+        int rk   = rank3(G);
+        if (compSize[c] == 1 && rk > 2) rk = 2;
+        if (rk < need) {
+            if (nLabile < MAX_ISPIS)
+                printf("  [GRESKA] Deo sa cvorom %s (%d cvorova) ima %d neoslonjenih "
+                       "krutih pomeranja\n",
+                       nodeLabel(compRep[c]).c_str(), compSize[c], need - rk);
+            nLabile++;
+        }
+    }
+    if (nLabile > MAX_ISPIS)
+        printf("  [GRESKA] ... ukupno labilnih delova: %d\n", nLabile);
+    errors += nLabile;
+
+    if (errors == 0)
+        printf("  [OK] Nisu pronadjene strukturne greske\n");
+    return errors == 0;
+}
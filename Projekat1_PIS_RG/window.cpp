@@ -1,17 +1,31 @@
 #include "window.h"
 #include "utils.h"
+#include "autosave.h"
+#include "dynamics.h"
+#include "solver.h"
+#include "sweep.h"
+#include "substructure.h"
+#include "modal.h"
+#include "crossings.h"
+#include "picking.h"
+#include "replay.h"
 #include <cstdio>
 #include <cmath>
 #include <cstring>
 #include <cstdlib>
 #include <string>
+#include <vector>
+#include <algorithm>
 
 // ─────────────────────────────────────────────
 //  Stanje prozora
 // ─────────────────────────────────────────────
-static int   windowWidth  = 800;
-static int   windowHeight = 800;
-static float camX = 0.0f, camY = 0.0f, camZoom = 1.0f;
+// Pogled je po niti: offscreen renderovanje crta plocice u vise niti,
+// svaka sa svojim pogledom (vidi renderView)
+static thread_local int   windowWidth  = 800;
+static thread_local int   windowHeight = 800;
+static thread_local float camX = 0.0f, camY = 0.0f, camZoom = 1.0f;
+static thread_local bool  offscreen = false;   // bez GLUT-a → bez teksta
 
 // RMB crtanje stapa
 static int rmb_firstNode = -1;
@@ -24,6 +38,31 @@ static float pendingForceAngleDeg = 270.0f;
 static int   pendingSupNode     = -1;
 static float pendingSupAngleDeg = 270.0f;
 
+// Izbor stapova u MODE_MATERIAL (LMB: klik / pravougaonik, RMB: laso)
+static std::vector<int>  selMembers;          // izabrani stapovi
+static std::vector<char> selFlag;             // selFlag[i] = stap i je izabran
+static int   dragButton = -1;                 // dugme koje se vuce, -1 = nista
+static bool  dragMoved  = false;              // pomeren dalje od praga klika
+static bool  dragAdd    = false;              // Shift: dodaj u izbor
+static int   dragSX = 0, dragSY = 0;          // pocetak vucenja (ekran)
+static float dragX0 = 0, dragY0 = 0, dragX1 = 0, dragY1 = 0;   // pravougaonik (svet)
+static std::vector<float> lasso;              // temena lasa (svet)
+
+static const int PICK_TOLERANCE_PX = 8;
+
+// Prikaz sopstvenog oblika (modalna analiza / izvijanje)
+static int   shownMode    = -1;      // -1 = bez prikaza
+static float modePhase    = 0.0f;    // faza animacije [rad]
+static bool  modeTimerSet = false;
+static const int MODE_FRAME_MS = 40;
+
+// Preseci stapova (taster C); prikaz vazi do prve izmene cvorova ili stapova
+static std::vector<Crossing> crossings;
+static std::vector<char>     crossFlag;       // crossFlag[i] = stap i je u preseku
+
+// Automatsko cuvanje (snimak se pravi na UI niti, upis u pozadini)
+static const int AUTOSAVE_PERIOD_MS = 30000;
+
 // ─────────────────────────────────────────────
 //  Labele cvorova (A, B, ..., Z, AA, AB, ...)
 // ─────────────────────────────────────────────
@@ -37,12 +76,22 @@ static std::string nodeLabel(int i)
     return s;
 }
 
+// ─────────────────────────────────────────────
+//  Tekst (GLUT bitmap font; u offscreen modu GLUT nije inicijalizovan)
+// ─────────────────────────────────────────────
+static void drawText(void* font, const char* text)
+{
+    if (offscreen) return;
+    for (const char* c = text; *c; c++) glutBitmapCharacter(font, *c);
+}
+
 // ─────────────────────────────────────────────
 //  Terminalni unos — blokirajuci (prozor stoji)
 // ─────────────────────────────────────────────
 static void askElementProps(int elemIdx)
 {
-    double E_GPa = 210.0, A_cm2 = 10.0;
+    double E_GPa = 210.0, A_cm2 = 10.0, rho = 7850.0;
+    if ((int)app.sections.size() >= MAX_SECTIONS) compactSections();
 
     printf("\n  Stap %d  (cvorovi %s-%s)\n",
            elemIdx + 1,
@@ -50,18 +99,134 @@ static void askElementProps(int elemIdx)
            nodeLabel(app.elements[elemIdx].n2).c_str());
     printf("  Unesite modul elasticnosti E [GPa]: ");
     fflush(stdout);
-    if (scanf("%lf", &E_GPa) != 1) E_GPa = 210.0;
+    if (!promptDouble(E_GPa)) E_GPa = 210.0;
 
     printf("  Unesite povrsinu poprecnog preseka A [cm^2]: ");
     fflush(stdout);
-    if (scanf("%lf", &A_cm2) != 1) A_cm2 = 10.0;
+    if (!promptDouble(A_cm2)) A_cm2 = 10.0;
+
+    printf("  Unesite gustinu materijala rho [kg/m^3]: ");
+    fflush(stdout);
+    if (!promptDouble(rho)) rho = 7850.0;
     printf("\n");
 
-    if (elemIdx < (int)app.elements.size()) {
-        app.elements[elemIdx].E = (float)(E_GPa * 1e9);
-        app.elements[elemIdx].A = (float)(A_cm2 * 1e-4);
+    int sec = findOrAddSection((float)(E_GPa * 1e9), (float)(A_cm2 * 1e-4), (float)rho);
+    if (sec < 0) {
+        printf("  [GRESKA] Tabela sekcija je puna (%d) — sekcija nije promenjena\n\n", MAX_SECTIONS);
+    } else if (elemIdx < (int)app.elements.size()) {
+        app.elements[elemIdx].section = (uint16_t)sec;
+        app.currentSection            = (uint16_t)sec;
+        markDirty(ARR_ELEMENTS, elemIdx, elemIdx + 1);
+        shownMode = -1;   // oblik vise ne odgovara krutosti / masi
     }
-    glutPostRedisplay();
+    requestRedisplay();
+}
+
+// Zajednicki E / A / rho za sve izabrane stapove; nevazeci unos (npr. "-")
+// ostavlja tu velicinu svakom stapu kakva je bila
+static bool askOptional(const char* prompt, double& value)
+{
+    printf("%s", prompt);
+    fflush(stdout);
+    return promptDouble(value);
+}
+
+static void askSelectionProps()
+{
+    if (selMembers.empty()) {
+        printf("\n  [INFO] Nijedan stap nije izabran (LMB: klik / pravougaonik, RMB: laso)\n\n");
+        return;
+    }
+    if (selMembers.size() == 1) { askElementProps(selMembers[0]); return; }
+
+    // Svaka dodela ostavlja stare sekcije; pre remap-a (indeksi!) se cisti
+    if ((int)app.sections.size() >= MAX_SECTIONS) compactSections();
+
+    double E_GPa = 0.0, A_cm2 = 0.0, rho = 0.0;
+    printf("\n  Izabrano stapova: %d   (\"-\" = bez promene)\n", (int)selMembers.size());
+    bool setE   = askOptional("  Unesite modul elasticnosti E [GPa]: ", E_GPa);
+    bool setA   = askOptional("  Unesite povrsinu poprecnog preseka A [cm^2]: ", A_cm2);
+    bool setRho = askOptional("  Unesite gustinu materijala rho [kg/m^3]: ", rho);
+
+    // Nova sekcija zavisi samo od stare, pa se racuna jednom po staroj sekciji
+    std::vector<int> remap(app.sections.size(), -2);   // -2 = jos nije racunato
+    for (int i : selMembers) {
+        if (i >= (int)app.elements.size()) continue;
+        int old = app.elements[i].section;
+        if (remap[old] == -2) {
+            Section s = app.sections[old];
+            if (setE)   s.E   = (float)(E_GPa * 1e9);
+            if (setA)   s.A   = (float)(A_cm2 * 1e-4);
+            if (setRho) s.rho = (float)rho;
+            remap[old] = findOrAddSection(s.E, s.A, s.rho);
+            if (remap[old] < 0)
+                printf("  [GRESKA] Tabela sekcija je puna — deo stapova nije promenjen\n");
+        }
+        if (remap[old] >= 0) {
+            app.elements[i].section = (uint16_t)remap[old];
+            markDirty(ARR_ELEMENTS, i, i + 1);
+        }
+    }
+    printf("  [OK] Dodeljeno %d stapova\n\n", (int)selMembers.size());
+    shownMode = -1;
+    requestRedisplay();
+}
+
+// Izmena sekcije menja sve stapove koji je koriste, bez obilaska stapova
+static void askSectionEdit()
+{
+    compactSections();   // lista prikazuje samo sekcije u upotrebi
+    std::vector<long> users(app.sections.size(), 0);
+    for (const Element& e : app.elements) users[e.section]++;
+
+    printf("\n  Sekcije\n");
+    printf("  br     E [GPa]      A [cm^2]     rho [kg/m^3]   stapova\n");
+    for (int i = 0; i < (int)app.sections.size(); i++) {
+        const Section& s = app.sections[i];
+        printf("  %-5d  %-11.3f  %-11.4f  %-13.1f  %ld\n", i,
+               s.E * 1e-9, s.A * 1e4, (double)s.rho, users[i]);
+    }
+
+    int idx = -1;
+    printf("  Broj sekcije za izmenu: ");
+    fflush(stdout);
+    if (!promptInt(idx) || idx < 0 || idx >= (int)app.sections.size()) {
+        printf("  Odustano.\n\n");
+        return;
+    }
+
+    double E_GPa = 0.0, A_cm2 = 0.0, rho = 0.0;
+    printf("  (\"-\" = bez promene)\n");
+    Section& s = app.sections[idx];
+    if (askOptional("  Unesite modul elasticnosti E [GPa]: ", E_GPa))          s.E   = (float)(E_GPa * 1e9);
+    if (askOptional("  Unesite povrsinu poprecnog preseka A [cm^2]: ", A_cm2)) s.A   = (float)(A_cm2 * 1e-4);
+    if (askOptional("  Unesite gustinu materijala rho [kg/m^3]: ", rho))       s.rho = (float)rho;
+    markDirty(ARR_SECTIONS, idx, idx + 1);
+    sectionsChanged();
+    shownMode = -1;
+    printf("  [OK] Sekcija %d izmenjena (%ld stapova)\n\n", idx, users[idx]);
+    requestRedisplay();
+}
+
+static void clearSelection()
+{
+    for (int i : selMembers)
+        if (i < (int)selFlag.size()) selFlag[i] = 0;
+    selMembers.clear();
+}
+
+// Shift + klik na izabran stap ga izbacuje iz izbora
+static void selectMembers(const std::vector<int>& picked, bool add, bool toggle)
+{
+    if (!add) clearSelection();
+    selFlag.resize(app.elements.size(), 0);
+    if (toggle && picked.size() == 1 && selFlag[picked[0]]) {
+        selFlag[picked[0]] = 0;
+        selMembers.erase(std::find(selMembers.begin(), selMembers.end(), picked[0]));
+        return;
+    }
+    for (int i : picked)
+        if (!selFlag[i]) { selFlag[i] = 1; selMembers.push_back(i); }
 }
 
 static void askForceProps(int nodeIdx, float angleDeg)
@@ -72,7 +237,7 @@ static void askForceProps(int nodeIdx, float angleDeg)
     printf("  Smer sile: %.0f deg\n", angleDeg);
     printf("  Unesite intenzitet sile F [N]: ");
     fflush(stdout);
-    if (scanf("%lf", &F) != 1) F = 10000.0;
+    if (!promptDouble(F)) F = 10000.0;
     printf("\n");
 
     Force f;
@@ -80,7 +245,199 @@ static void askForceProps(int nodeIdx, float angleDeg)
     f.magnitude = (float)F;
     f.angle     = angleDeg * (float)M_PI / 180.0f;
     app.forces.push_back(f);
-    glutPostRedisplay();
+    shownMode = -1;   // izvijanje zavisi od opterecenja
+    requestRedisplay();
+}
+
+static void askTimeLoad(int nodeIdx, float angleDeg)
+{
+    int n = 0;
+
+    printf("\n  Vremenska istorija sile na cvoru %s\n", nodeLabel(nodeIdx).c_str());
+    printf("  Smer sile: %.0f deg\n", angleDeg);
+    printf("  Broj tacaka istorije: ");
+    fflush(stdout);
+    if (!promptInt(n) || n <= 0) {
+        printf("  Odustano.\n\n");
+        return;
+    }
+
+    TimeLoad tl;
+    tl.node  = nodeIdx;
+    tl.angle = angleDeg * (float)M_PI / 180.0f;
+    for (int i = 0; i < n; i++) {
+        double t = 0.0, F = 0.0;
+        printf("  Tacka %d — t [s] i F [N]: ", i + 1);
+        fflush(stdout);
+        if (!promptDouble(t) || !promptDouble(F)) break;
+        if (!tl.t.empty() && t <= tl.t.back()) {
+            printf("  [GRESKA] Vreme mora da raste — tacka preskocena\n");
+            continue;
+        }
+        tl.t.push_back((float)t);
+        tl.F.push_back((float)F);
+    }
+    printf("\n");
+
+    if (!tl.t.empty()) app.timeLoads.push_back(tl);
+    requestRedisplay();
+}
+
+static void askDynamicsParams()
+{
+    DynamicsParams p;
+
+    printf("\n  Dinamicka analiza (centralne razlike)\n");
+    printf("  Trajanje t_kraj [s]: ");
+    fflush(stdout);
+    if (!promptDouble(p.tEnd) || p.tEnd <= 0.0) p.tEnd = 1.0;
+
+    printf("  Vremenski korak dt [s] (0 = automatski): ");
+    fflush(stdout);
+    if (!promptDouble(p.dt)) p.dt = 0.0;
+
+    printf("  Snimak svakih N koraka: ");
+    fflush(stdout);
+    if (!promptInt(p.outputEvery)) p.outputEvery = 100;
+
+    printf("  Prigusenje alfa [1/s]: ");
+    fflush(stdout);
+    if (!promptDouble(p.damping)) p.damping = 0.0;
+    printf("\n");
+
+    runDynamics(p);
+}
+
+static void askSweepParams()
+{
+    SweepParams p;
+    char odgovor[16] = "ne";
+
+    printf("\n  Monte Carlo / parametarska analiza\n");
+    printf("  Pravilna mreza faktora umesto slucajnih uzoraka? (da/ne): ");
+    fflush(stdout);
+    if (!promptToken(odgovor, sizeof(odgovor))) {}
+    if (odgovor[0] == 'd' || odgovor[0] == 'D') {
+        p.mode = SWEEP_GRID;
+        printf("  Broj nivoa po parametru (E, A, F): ");
+        fflush(stdout);
+        if (!promptInt(p.gridLevels)) p.gridLevels = 5;
+        printf("  Raspon faktora +- [%%]: ");
+        fflush(stdout);
+        if (!promptDouble(p.gridRange)) p.gridRange = 10.0;
+        p.gridRange /= 100.0;
+    } else {
+        printf("  Broj uzoraka: ");
+        fflush(stdout);
+        if (!promptInt(p.samples)) p.samples = 1000;
+        printf("  Koef. varijacije E, A, F [%%]: ");
+        fflush(stdout);
+        if (!promptDouble(p.covE) || !promptDouble(p.covA) || !promptDouble(p.covF)) {
+            p.covE = 5.0; p.covA = 3.0; p.covF = 10.0;
+        }
+        p.covE /= 100.0; p.covA /= 100.0; p.covF /= 100.0;
+        printf("  Rasipanje ugla sile +- [deg]: ");
+        fflush(stdout);
+        if (!promptDouble(p.angleSpreadDeg)) p.angleSpreadDeg = 0.0;
+    }
+
+    double sigmaMPa = 235.0;
+    printf("  Dozvoljeni napon [MPa]: ");
+    fflush(stdout);
+    if (!promptDouble(sigmaMPa)) sigmaMPa = 235.0;
+    p.sigmaAllow = sigmaMPa * 1e6;
+    printf("\n");
+
+    runSweep(p);
+}
+
+static void askSubstructureParams()
+{
+    SubstructureParams p;
+
+    printf("\n  Proracun podstrukturama\n");
+    printf("  Duzina modula [m] (0 = automatski): ");
+    fflush(stdout);
+    if (!promptDouble(p.moduleLength) || p.moduleLength < 0.0) p.moduleLength = 0.0;
+    printf("\n");
+
+    solveSubstructured(p);
+}
+
+static void askEigenParams(EigenKind kind)
+{
+    EigenParams p;
+    p.kind = kind;
+
+    printf("\n  %s\n", kind == EIGEN_MODAL ? "Modalna analiza" : "Linearno izvijanje");
+    printf("  Broj najnizih modova: ");
+    fflush(stdout);
+    if (!promptInt(p.modes) || p.modes < 1) p.modes = 6;
+
+    if (kind == EIGEN_MODAL) {
+        char odgovor[16] = "ne";
+        printf("  Konzistentna masa umesto koncentrisane? (da/ne): ");
+        fflush(stdout);
+        if (!promptToken(odgovor, sizeof(odgovor))) {}
+        if (odgovor[0] == 'd' || odgovor[0] == 'D') p.mass = MASS_CONSISTENT;
+    }
+    printf("\n");
+
+    shownMode = runEigen(p) ? 0 : -1;
+    modePhase = 0.0f;
+    requestRedisplay();
+}
+
+// Poziva se posle svakog dodavanja / brisanja cvora ili stapa: prikazi
+// vezani za indekse cvorova i stapova vise ne vaze
+static void topologyChanged()
+{
+    crossings.clear();
+    crossFlag.clear();
+    shownMode = -1;
+}
+
+static void checkCrossings()
+{
+    findCrossings(crossings);
+
+    int nKind[3] = { 0, 0, 0 };
+    for (const Crossing& c : crossings) nKind[c.kind]++;
+    printf("\n  Provera preseka stapova\n");
+    printf("  Preseka bez cvora: %d   cvorova na stapu: %d   preklapanja: %d\n",
+           nKind[CROSS_PROPER], nKind[CROSS_TOUCH], nKind[CROSS_OVERLAP]);
+    for (size_t i = 0; i < crossings.size() && i < 10; i++) {
+        const Crossing& c = crossings[i];
+        const char* what = c.kind == CROSS_PROPER ? "presek" :
+                           c.kind == CROSS_TOUCH  ? "dodir"  : "preklapanje";
+        if (c.node >= 0)
+            printf("            stapovi %d i %d: %s u cvoru %s\n", c.a + 1, c.b + 1,
+                   what, nodeLabel(c.node).c_str());
+        else
+            printf("            stapovi %d i %d: %s u (%.3f, %.3f)\n", c.a + 1, c.b + 1,
+                   what, c.x, c.y);
+    }
+
+    crossFlag.assign(app.elements.size(), 0);
+    for (const Crossing& c : crossings) crossFlag[c.a] = crossFlag[c.b] = 1;
+
+    if (crossings.empty()) {
+        printf("  [OK] Stapovi se ne seku\n\n");
+        return;
+    }
+
+    char odgovor[16] = "ne";
+    printf("  Podeliti stapove u presecima? (da/ne): ");
+    fflush(stdout);
+    if (!promptToken(odgovor, sizeof(odgovor))) {}
+    printf("\n");
+    if (odgovor[0] != 'd' && odgovor[0] != 'D') return;
+
+    splitCrossings(crossings);
+    topologyChanged();
+    clearSelection();
+    pickInvalidate();
+    checkCrossings();
 }
 
 static void askSupportType(int nodeIdx, float angle)
@@ -90,7 +447,7 @@ static void askSupportType(int nodeIdx, float angle)
     printf("\n  Oslonac na cvoru %s\n", nodeLabel(nodeIdx).c_str());
     printf("  Da li je oslonac pokretni? (da/ne): ");
     fflush(stdout);
-    if (scanf("%15s", odgovor) != 1) {}
+    if (!promptToken(odgovor, sizeof(odgovor))) {}
     printf("\n");
 
     SupportType tip = FIXED;
@@ -101,7 +458,8 @@ static void askSupportType(int nodeIdx, float angle)
     s.type  = tip;
     s.angle = angle;
     app.supports.push_back(s);
-    glutPostRedisplay();
+    shownMode = -1;
+    requestRedisplay();
 }
 
 // ─────────────────────────────────────────────
@@ -117,22 +475,43 @@ static void screenToWorld(int sx, int sy, float& wx, float& wy)
 }
 
 // ─────────────────────────────────────────────
-//  drawGrid
+//  Vidljivi deo sveta i odsecanje
 // ─────────────────────────────────────────────
-void drawGrid()
+static void viewBounds(float& xMin, float& xMax, float& yMin, float& yMax)
 {
     float aspect = (float)windowWidth / (float)windowHeight;
     float halfH  = 10.0f / camZoom;
     float halfW  = halfH * aspect;
-    float xMin = camX - halfW, xMax = camX + halfW;
-    float yMin = camY - halfH, yMax = camY + halfH;
+    xMin = camX - halfW; xMax = camX + halfW;
+    yMin = camY - halfH; yMax = camY + halfH;
+}
+
+// Da li pravougaonik oko duzi (prosiren za `margin`) sece pogled
+static bool boxVisible(float x1, float y1, float x2, float y2, float margin)
+{
+    float xMin, xMax, yMin, yMax;
+    viewBounds(xMin, xMax, yMin, yMax);
+    return fminf(x1, x2) - margin <= xMax && fmaxf(x1, x2) + margin >= xMin &&
+           fminf(y1, y2) - margin <= yMax && fmaxf(y1, y2) + margin >= yMin;
+}
+
+// ─────────────────────────────────────────────
+//  drawGrid
+// ─────────────────────────────────────────────
+void drawGrid()
+{
+    float xMin, xMax, yMin, yMax;
+    viewBounds(xMin, xMax, yMin, yMax);
+
+    // Mreza gusca od 4 piksela po metru samo zacrni sliku — crtaju se samo ose
+    bool dense = (float)windowHeight / (yMax - yMin) < 4.0f;
 
     glColor3f(0.88f, 0.88f, 0.88f);
     glBegin(GL_LINES);
-    for (float x = floorf(xMin); x <= xMax; x += 1.0f) {
+    for (float x = floorf(xMin); !dense && x <= xMax; x += 1.0f) {
         glVertex2f(x, yMin); glVertex2f(x, yMax);
     }
-    for (float y = floorf(yMin); y <= yMax; y += 1.0f) {
+    for (float y = floorf(yMin); !dense && y <= yMax; y += 1.0f) {
         glVertex2f(xMin, y); glVertex2f(xMax, y);
     }
     glEnd();
@@ -145,18 +524,20 @@ void drawGrid()
     glEnd();
     glLineWidth(1.0f);
 
+    if (dense || offscreen) return;
+
     glColor3f(0.45f, 0.45f, 0.45f);
     for (float x = floorf(xMin); x <= xMax; x += 1.0f) {
         if (fabsf(x) < 0.1f) continue;
         char buf[8]; snprintf(buf, sizeof(buf), "%.0f", x);
         glRasterPos2f(x + 0.05f, 0.1f);
-        for (const char* c = buf; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_10, *c);
+        drawText(GLUT_BITMAP_HELVETICA_10, buf);
     }
     for (float y = floorf(yMin) + 1.0f; y <= yMax; y += 1.0f) {
         if (fabsf(y) < 0.1f) continue;
         char buf[8]; snprintf(buf, sizeof(buf), "%.0f", y);
         glRasterPos2f(0.1f, y);
-        for (const char* c = buf; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_10, *c);
+        drawText(GLUT_BITMAP_HELVETICA_10, buf);
     }
 }
 
@@ -173,9 +554,15 @@ void drawTruss()
         const Element& e = app.elements[i];
         float x1 = app.nodes[e.n1].x, y1 = app.nodes[e.n1].y;
         float x2 = app.nodes[e.n2].x, y2 = app.nodes[e.n2].y;
-
-        glColor3f(0.15f, 0.15f, 0.15f);
-        glLineWidth(2.5f);
+        if (!boxVisible(x1, y1, x2, y2, 0.5f)) continue;
+        bool sel = !offscreen && app.mode == MODE_MATERIAL &&
+                   i < (int)selFlag.size() && selFlag[i];
+        bool crossed = !offscreen && i < (int)crossFlag.size() && crossFlag[i];
+
+        if (sel)          glColor3f(1.0f, 0.55f, 0.0f);   // narandzast = izabran
+        else if (crossed) glColor3f(0.85f, 0.1f, 0.1f);   // crven = u preseku
+        else              glColor3f(0.15f, 0.15f, 0.15f);
+        glLineWidth(sel ? 4.0f : 2.5f);
         glBegin(GL_LINES);
         glVertex2f(x1, y1); glVertex2f(x2, y2);
         glEnd();
@@ -187,12 +574,27 @@ void drawTruss()
         char numBuf[8]; snprintf(numBuf, sizeof(numBuf), "%d", i+1);
         glColor3f(0.0f, 0.0f, 0.0f);
         glRasterPos2f(mx + 0.06f, my + 0.18f);
-        for (const char* c = numBuf; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+        drawText(GLUT_BITMAP_HELVETICA_18, numBuf);
+    }
+
+    // Tacke preseka — crveni X
+    if (!offscreen && !crossings.empty()) {
+        glColor3f(0.85f, 0.1f, 0.1f);
+        glLineWidth(2.0f);
+        glBegin(GL_LINES);
+        for (const Crossing& c : crossings) {
+            if (!boxVisible(c.x, c.y, c.x, c.y, 0.5f)) continue;
+            glVertex2f(c.x - 0.2f, c.y - 0.2f); glVertex2f(c.x + 0.2f, c.y + 0.2f);
+            glVertex2f(c.x - 0.2f, c.y + 0.2f); glVertex2f(c.x + 0.2f, c.y - 0.2f);
+        }
+        glEnd();
+        glLineWidth(1.0f);
     }
 
     // Cvorovi (oznaka: slovo iznad)
     for (int i = 0; i < (int)app.nodes.size(); i++) {
         float x = app.nodes[i].x, y = app.nodes[i].y;
+        if (!boxVisible(x, y, x, y, 0.5f)) continue;
         bool  sel  = (app.mode == MODE_DRAW && i == rmb_firstNode);
         bool  pend = (app.mode == MODE_FORCE  && i == pendingForceNode) ||
                      (app.mode == MODE_SUPPORT && i == pendingSupNode);
@@ -226,8 +628,7 @@ void drawTruss()
         std::string lbl = nodeLabel(i);
         glColor3f(0.05f, 0.05f, 0.55f);
         glRasterPos2f(x - 0.08f, y + 0.22f);
-        for (const char* c = lbl.c_str(); *c; c++)
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+        drawText(GLUT_BITMAP_HELVETICA_18, lbl.c_str());
     }
 
     // Preview rotacije oslonca — isti simbol, narandzast, isprekidan
@@ -253,7 +654,7 @@ void drawTruss()
         char buf[32]; snprintf(buf, sizeof(buf), "%.0f deg", pendingSupAngleDeg);
         glColor3f(0.7f, 0.35f, 0.0f);
         glRasterPos2f(x + 0.6f, y - 0.8f);
-        for (const char* c = buf; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+        drawText(GLUT_BITMAP_HELVETICA_12, buf);
     }
 
     // Preview strelica za pending silu
@@ -287,10 +688,49 @@ void drawTruss()
         char buf[32]; snprintf(buf, sizeof(buf), "%.0f deg", pendingForceAngleDeg);
         glColor3f(0.7f, 0.35f, 0.0f);
         glRasterPos2f(x - dx*L + 0.1f, y - dy*L - 0.25f);
-        for (const char* c = buf; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+        drawText(GLUT_BITMAP_HELVETICA_12, buf);
     }
 }
 
+// ─────────────────────────────────────────────
+//  drawModeShape — animirani sopstveni oblik preko modela
+// ─────────────────────────────────────────────
+// Najvece pomeranje cvora je 10 % vece dimenzije modela
+static void drawModeShape()
+{
+    const ModeShapes& ms = lastModeShapes();
+    if (shownMode < 0 || shownMode >= ms.nModes || ms.nNodes != (int)app.nodes.size()) return;
+
+    float x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+    for (const Node& n : app.nodes) {
+        x0 = std::min(x0, n.x); x1 = std::max(x1, n.x);
+        y0 = std::min(y0, n.y); y1 = std::max(y1, n.y);
+    }
+    const float  amp = 0.1f * std::max(std::max(x1 - x0, y1 - y0), 1.0f) * cosf(modePhase);
+    const float* phi = &ms.shape[(size_t)shownMode * 2 * ms.nNodes];
+
+    glColor3f(0.85f, 0.1f, 0.55f);
+    glLineWidth(2.0f);
+    glBegin(GL_LINES);
+    for (const Element& e : app.elements) {
+        float ax = app.nodes[e.n1].x + amp * phi[2*e.n1], ay = app.nodes[e.n1].y + amp * phi[2*e.n1 + 1];
+        float bx = app.nodes[e.n2].x + amp * phi[2*e.n2], by = app.nodes[e.n2].y + amp * phi[2*e.n2 + 1];
+        if (!boxVisible(ax, ay, bx, by, 0.5f)) continue;
+        glVertex2f(ax, ay); glVertex2f(bx, by);
+    }
+    glEnd();
+    glLineWidth(1.0f);
+}
+
+static void modeTimer(int)
+{
+    modeTimerSet = false;
+    if (shownMode < 0) return;
+    modePhase += 2.0f * (float)M_PI * MODE_FRAME_MS / 1500.0f;   // perioda 1.5 s
+    if (modePhase > 2.0f * (float)M_PI) modePhase -= 2.0f * (float)M_PI;
+    requestRedisplay();
+}
+
 // ─────────────────────────────────────────────
 //  drawForces
 // ─────────────────────────────────────────────
@@ -299,6 +739,7 @@ void drawForces()
     for (const Force& f : app.forces) {
         float x  = app.nodes[f.node].x;
         float y  = app.nodes[f.node].y;
+        if (!boxVisible(x, y, x, y, 2.0f)) continue;
         float dx = cosf(f.angle), dy = sinf(f.angle);
         float L  = 1.2f;
 
@@ -321,7 +762,39 @@ void drawForces()
         snprintf(buf, sizeof(buf), "%.0f N @ %.0f deg", (double)f.magnitude, (double)deg);
         glColor3f(0.7f, 0.0f, 0.0f);
         glRasterPos2f(x - dx*L - 0.05f, y - dy*L - 0.28f);
-        for (const char* c = buf; *c; c++) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+        drawText(GLUT_BITMAP_HELVETICA_12, buf);
+    }
+
+    // Sile sa vremenskom istorijom — ljubicasto, oznaka sa max |F(t)|
+    for (const TimeLoad& tl : app.timeLoads) {
+        float x  = app.nodes[tl.node].x;
+        float y  = app.nodes[tl.node].y;
+        if (!boxVisible(x, y, x, y, 2.0f)) continue;
+        float dx = cosf(tl.angle), dy = sinf(tl.angle);
+        float L  = 1.2f;
+
+        glColor3f(0.55f, 0.1f, 0.7f);
+        glLineWidth(2.0f);
+        glBegin(GL_LINES);
+        glVertex2f(x - dx*L, y - dy*L); glVertex2f(x, y);
+        glEnd();
+        glLineWidth(1.0f);
+
+        float hL = 0.28f, hA = 0.38f;
+        glBegin(GL_TRIANGLES);
+        glVertex2f(x, y);
+        glVertex2f(x - hL*cosf(tl.angle - hA), y - hL*sinf(tl.angle - hA));
+        glVertex2f(x - hL*cosf(tl.angle + hA), y - hL*sinf(tl.angle + hA));
+        glEnd();
+
+        float Fmax = 0.0f;
+        for (float F : tl.F) if (fabsf(F) > Fmax) Fmax = fabsf(F);
+        float deg = tl.angle * 180.0f / (float)M_PI;
+        char buf[48];
+        snprintf(buf, sizeof(buf), "F(t) max %.0f N @ %.0f deg", (double)Fmax, (double)deg);
+        glColor3f(0.4f, 0.0f, 0.55f);
+        glRasterPos2f(x - dx*L - 0.05f, y - dy*L - 0.28f);
+        drawText(GLUT_BITMAP_HELVETICA_12, buf);
     }
 }
 
@@ -375,6 +848,8 @@ static void drawSupportSymbol(float x, float y, SupportType type, float angle)
 void drawSupports()
 {
     for (const Support& s : app.supports) {
+        float x = app.nodes[s.node].x, y = app.nodes[s.node].y;
+        if (!boxVisible(x, y, x, y, 1.0f)) continue;
         drawSupportSymbol(app.nodes[s.node].x, app.nodes[s.node].y, s.type, s.angle);
     }
 }
@@ -397,15 +872,21 @@ void drawUI()
     const char* controls[] = {
         "--- KONTROLE ---",
         "B - Mod Crtanja (LMB: Cvor, RMB: Stap)",
-        "F - Mod Sila (LMB na cvor: Dodaj/Rotiraj)",
+        "F - Mod Sila (LMB na cvor: Dodaj/Rotiraj   H: Vremenska istorija)",
         "S - Mod Oslonca (LMB: Dodaj → unos tipa   LMB opet: Rotiraj)",
-        "E - Unos Materijala",
+        "E - Mod Materijala (LMB: Stap/Pravougaonik  RMB: Laso  Shift: Dodaj  Enter: Unos E/A  X: Sekcije)",
         "G - Generisi MKE-2D.ulz",
+        "K - Sacuvaj kompaktno (MKE-2D.ulzb)   L - Ucitaj MKE-2D.ulzb",
+        "P - Staticki proracun   U - Podstrukture   M - Monte Carlo / parametarska analiza",
+        "T - Dinamicka analiza (MKE-2D.dyn)   N - Modalna analiza   V - Izvijanje   ,/. - Mod",
+        "C - Provera preseka stapova (podela u presecima)",
         "Q - Izlaz"
     };
+    const int nControls = (int)(sizeof(controls) / sizeof(controls[0]));
 
-    float yPos = -0.70f;
-    for (int i = 0; i < 7; i++) {
+    // Poslednji red (i hint ispod njega) ostaje iznad donje ivice
+    float yPos = -0.90f + 0.05f * (nControls - 1);
+    for (int i = 0; i < nControls; i++) {
         bool active = (i==1 && app.mode==MODE_DRAW)     ||
                       (i==2 && app.mode==MODE_FORCE)    ||
                       (i==3 && app.mode==MODE_SUPPORT)  ||
@@ -418,8 +899,7 @@ void drawUI()
             glColor3f(0.3f, 0.3f, 0.3f);
 
         glRasterPos2f(-aspect + 0.03f, yPos);
-        for (const char* c = controls[i]; *c; c++)
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+        drawText(GLUT_BITMAP_HELVETICA_12, controls[i]);
         yPos -= 0.05f;
     }
 
@@ -428,8 +908,26 @@ void drawUI()
         glColor3f(0.75f, 0.35f, 0.0f);
         glRasterPos2f(-aspect + 0.03f, yPos - 0.02f);
         const char* hint = ">> Strelica L/D = rotiraj   LMB na isti cvor = potvrdi";
-        for (const char* c = hint; *c; c++)
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+        drawText(GLUT_BITMAP_HELVETICA_12, hint);
+    } else if (shownMode >= 0 && shownMode < lastModeShapes().nModes) {
+        const ModeShapes& ms = lastModeShapes();
+        char hint[96];
+        if (ms.kind == EIGEN_MODAL)
+            snprintf(hint, sizeof(hint), ">> Mod %d / %d   f = %.4g Hz   Esc = sakrij",
+                     shownMode + 1, ms.nModes, ms.value[shownMode]);
+        else
+            snprintf(hint, sizeof(hint), ">> Mod izvijanja %d / %d   faktor = %.4g   Esc = sakrij",
+                     shownMode + 1, ms.nModes, ms.value[shownMode]);
+        glColor3f(0.85f, 0.1f, 0.55f);
+        glRasterPos2f(-aspect + 0.03f, yPos - 0.02f);
+        drawText(GLUT_BITMAP_HELVETICA_12, hint);
+    } else if (app.mode == MODE_MATERIAL && !selMembers.empty()) {
+        char hint[96];
+        snprintf(hint, sizeof(hint), ">> Izabrano stapova: %d   Enter = unos E/A/rho   Esc = ponisti",
+                 (int)selMembers.size());
+        glColor3f(0.75f, 0.35f, 0.0f);
+        glRasterPos2f(-aspect + 0.03f, yPos - 0.02f);
+        drawText(GLUT_BITMAP_HELVETICA_12, hint);
     }
 
     glMatrixMode(GL_PROJECTION);
@@ -442,49 +940,164 @@ void drawUI()
 // ─────────────────────────────────────────────
 //  display
 // ─────────────────────────────────────────────
-void display()
+static void drawScene()
 {
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    float aspect = (float)windowWidth / (float)windowHeight;
-    float halfH  = 10.0f / camZoom;
-    float halfW  = halfH * aspect;
+    float xMin, xMax, yMin, yMax;
+    viewBounds(xMin, xMax, yMin, yMax);
 
     glMatrixMode(GL_PROJECTION);
     glLoadIdentity();
-    gluOrtho2D(camX-halfW, camX+halfW, camY-halfH, camY+halfH);
+    gluOrtho2D(xMin, xMax, yMin, yMax);
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
     drawGrid();
     drawTruss();
+    drawModeShape();
     drawForces();
     drawSupports();
-    drawUI();
+}
 
+// Pravougaonik / laso dok se vuce misem (koordinate sveta)
+static void drawSelectionOverlay()
+{
+    if (dragButton < 0 || !dragMoved) return;
+    glColor3f(1.0f, 0.55f, 0.0f);
+    glLineWidth(1.5f);
+    glBegin(GL_LINE_LOOP);
+    if (dragButton == GLUT_LEFT_BUTTON) {
+        glVertex2f(dragX0, dragY0); glVertex2f(dragX1, dragY0);
+        glVertex2f(dragX1, dragY1); glVertex2f(dragX0, dragY1);
+    } else {
+        for (size_t i = 0; i + 1 < lasso.size(); i += 2)
+            glVertex2f(lasso[i], lasso[i+1]);
+    }
+    glEnd();
+    glLineWidth(1.0f);
+}
+
+void display()
+{
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawScene();
+    drawSelectionOverlay();
+    drawUI();
     glutSwapBuffers();
+
+    // Animacija oblika: sledeci kadar tek kad je ovaj iscrtan
+    if (shownMode >= 0 && !modeTimerSet) {
+        modeTimerSet = true;
+        glutTimerFunc(MODE_FRAME_MS, modeTimer, 0);
+    }
+}
+
+// ─────────────────────────────────────────────
+//  renderView — crtanje u tekuci (offscreen) GL kontekst
+// ─────────────────────────────────────────────
+// Pogled je thread_local, pa vise niti moze istovremeno da crta
+// razlicite plocice iste slike, svaka u svom kontekstu.
+void renderView(float xMin, float xMax, float yMin, float yMax, int w, int h)
+{
+    offscreen    = true;
+    windowWidth  = w;
+    windowHeight = (h > 0) ? h : 1;
+    camX    = 0.5f * (xMin + xMax);
+    camY    = 0.5f * (yMin + yMax);
+    camZoom = 20.0f / (yMax - yMin);
+
+    glViewport(0, 0, windowWidth, windowHeight);
+    glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawScene();
+    glFinish();
 }
 
 // ─────────────────────────────────────────────
 //  reshape
 // ─────────────────────────────────────────────
-void reshape(int w, int h)
+void resizeView(int w, int h)
 {
     windowWidth  = w;
     windowHeight = (h > 0) ? h : 1;
+}
+
+void reshape(int w, int h)
+{
+    resizeView(w, h);
     glViewport(0, 0, windowWidth, windowHeight);
-    glutPostRedisplay();
+    requestRedisplay();
 }
 
 // ─────────────────────────────────────────────
 //  handleMouse
 // ─────────────────────────────────────────────
+// MODE_MATERIAL: klik bira najblizi stap, vucenje LMB bira pravougaonikom,
+// vucenje RMB lasom. Bez Shift-a novi izbor zamenjuje stari.
+static void materialMouse(int button, int state, int sx, int sy)
+{
+    float wx, wy;
+    screenToWorld(sx, sy, wx, wy);
+
+    if (state == GLUT_DOWN) {
+        dragButton = button;
+        dragMoved  = false;
+        dragAdd    = (inputModifiers() & GLUT_ACTIVE_SHIFT) != 0;
+        dragSX = sx; dragSY = sy;
+        dragX0 = dragX1 = wx;
+        dragY0 = dragY1 = wy;
+        lasso.assign({ wx, wy });
+        return;
+    }
+    if (button != dragButton) return;
+    dragButton = -1;
+
+    std::vector<int> picked;
+    if (!dragMoved) {
+        if (button != GLUT_LEFT_BUTTON) return;
+        float pxWorld = 20.0f / camZoom / (float)windowHeight;
+        int   idx     = pickNearest(wx, wy, PICK_TOLERANCE_PX * pxWorld);
+        if (idx >= 0) picked.push_back(idx);
+        selectMembers(picked, dragAdd, true);
+    } else if (button == GLUT_LEFT_BUTTON) {
+        pickRect(dragX0, dragY0, dragX1, dragY1, picked);
+        selectMembers(picked, dragAdd, false);
+    } else {
+        pickLasso(lasso, picked);
+        selectMembers(picked, dragAdd, false);
+    }
+    requestRedisplay();
+}
+
+void handleMotion(int sx, int sy)
+{
+    if (dragButton < 0) return;
+    if (!dragMoved && abs(sx - dragSX) + abs(sy - dragSY) < 4) return;
+    dragMoved = true;
+
+    float wx, wy;
+    screenToWorld(sx, sy, wx, wy);
+    dragX1 = wx; dragY1 = wy;
+    // Laso dobija novo teme tek na 3 piksela od prethodnog
+    float pxWorld = 20.0f / camZoom / (float)windowHeight;
+    float dx = wx - lasso[lasso.size() - 2], dy = wy - lasso.back();
+    if (dx*dx + dy*dy >= 9.0f * pxWorld * pxWorld) {
+        lasso.push_back(wx);
+        lasso.push_back(wy);
+    }
+    requestRedisplay();
+}
+
 void handleMouse(int button, int state, int sx, int sy)
 {
+    if (app.mode == MODE_MATERIAL &&
+        (button == GLUT_LEFT_BUTTON || button == GLUT_RIGHT_BUTTON)) {
+        materialMouse(button, state, sx, sy);
+        return;
+    }
     if (state != GLUT_DOWN) return;
 
-    if (button == 3) { camZoom *= 1.1f;  glutPostRedisplay(); return; }
-    if (button == 4) { camZoom /= 1.1f;  if (camZoom<0.05f) camZoom=0.05f; glutPostRedisplay(); return; }
+    if (button == 3) { camZoom *= 1.1f;  requestRedisplay(); return; }
+    if (button == 4) { camZoom /= 1.1f;  if (camZoom<0.05f) camZoom=0.05f; requestRedisplay(); return; }
     if (button != GLUT_LEFT_BUTTON && button != GLUT_RIGHT_BUTTON) return;
 
     float wx, wy;
@@ -500,12 +1113,13 @@ void handleMouse(int button, int state, int sx, int sy)
             if (idx == -1) {
                 Node n; n.x = wx; n.y = wy;
                 app.nodes.push_back(n);
+                topologyChanged();
             }
             rmb_firstNode = -1;
         }
         else if (button == GLUT_RIGHT_BUTTON) {
             int idx = findClosestNode(wx, wy);
-            if (idx == -1) { glutPostRedisplay(); return; }
+            if (idx == -1) { requestRedisplay(); return; }
 
             if (rmb_firstNode == -1) {
                 rmb_firstNode = idx;
@@ -519,10 +1133,10 @@ void handleMouse(int button, int state, int sx, int sy)
                 if (!exists) {
                     Element e;
                     e.n1 = rmb_firstNode; e.n2 = idx;
-                    e.E  = app.currentE;
-                    e.A  = app.currentA;
+                    e.section = app.currentSection;
                     int newIdx = (int)app.elements.size();
                     app.elements.push_back(e);
+                    topologyChanged();
                     // Automatski pitaj za E i A u terminalu
                     askElementProps(newIdx);
                 }
@@ -537,7 +1151,7 @@ void handleMouse(int button, int state, int sx, int sy)
     else if (app.mode == MODE_FORCE && button == GLUT_LEFT_BUTTON)
     {
         int idx = findClosestNode(wx, wy);
-        if (idx == -1) { glutPostRedisplay(); return; }
+        if (idx == -1) { requestRedisplay(); return; }
 
         if (pendingForceNode == -1) {
             // Korak 1: selektuj cvor
@@ -565,7 +1179,7 @@ void handleMouse(int button, int state, int sx, int sy)
     else if (app.mode == MODE_SUPPORT && button == GLUT_LEFT_BUTTON)
     {
         int idx = findClosestNode(wx, wy);
-        if (idx == -1) { glutPostRedisplay(); return; }
+        if (idx == -1) { requestRedisplay(); return; }
 
         if (pendingSupNode == -1) {
             // Korak 1: selektuj cvor
@@ -584,7 +1198,7 @@ void handleMouse(int button, int state, int sx, int sy)
         }
     }
 
-    glutPostRedisplay();
+    requestRedisplay();
 }
 
 // ─────────────────────────────────────────────
@@ -638,9 +1252,97 @@ void keyboard(unsigned char key, int, int)
         rmb_firstNode = -1;
         break;
 
+    case 13:  // Enter: E / A / rho za izabrane stapove
+        if (app.mode == MODE_MATERIAL) askSelectionProps();
+        break;
+
+    case 'x': case 'X':  // izmena sekcije za sve njene stapove
+        if (app.mode == MODE_MATERIAL) askSectionEdit();
+        break;
+
+    case 27:  // Esc: ponisti izbor stapova, sakrij sopstveni oblik
+        clearSelection();
+        shownMode = -1;
+        break;
+
     case 'g': case 'G':
         confirmPending();
-        saveToFile();
+        if (validateModel()) {
+            compactSections();
+            saveToFile();
+        } else {
+            printf("\n  [GRESKA] Izvoz prekinut — ispravite model pa pokusajte ponovo\n\n");
+        }
+        break;
+
+    case 'h': case 'H':
+        // Potvrdi smer pending sile, ali kao vremensku istoriju
+        if (pendingForceNode >= 0) {
+            int   n = pendingForceNode;
+            float a = pendingForceAngleDeg;
+            app.currentForceAngleDeg = a;
+            pendingForceNode = -1;
+            askTimeLoad(n, a);
+        }
+        break;
+
+    case 'p': case 'P':
+        confirmPending();
+        solveStatic();
+        break;
+
+    case 'u': case 'U':
+        confirmPending();
+        askSubstructureParams();
+        break;
+
+    case 'm': case 'M':
+        confirmPending();
+        askSweepParams();
+        break;
+
+    case 'n': case 'N':
+        confirmPending();
+        askEigenParams(EIGEN_MODAL);
+        break;
+
+    case 'v': case 'V':
+        confirmPending();
+        askEigenParams(EIGEN_BUCKLING);
+        break;
+
+    case ',': case '<':
+        if (shownMode > 0) shownMode--;
+        break;
+
+    case '.': case '>':
+        if (shownMode >= 0 && shownMode + 1 < lastModeShapes().nModes) shownMode++;
+        break;
+
+    case 'c': case 'C':
+        confirmPending();
+        checkCrossings();
+        break;
+
+    case 't': case 'T':
+        confirmPending();
+        askDynamicsParams();
+        break;
+
+    case 'k': case 'K':
+        confirmPending();
+        compactSections();
+        saveCompact("MKE-2D.ulzb");
+        break;
+
+    case 'l': case 'L':
+        pendingForceNode = -1;
+        pendingSupNode   = -1;
+        rmb_firstNode    = -1;
+        clearSelection();
+        topologyChanged();
+        loadCompact("MKE-2D.ulzb");
+        pickInvalidate();
         break;
 
     case '+': case '=': camZoom *= 1.2f; break;
@@ -657,14 +1359,21 @@ void keyboard(unsigned char key, int, int)
         int last = (int)app.nodes.size()-1;
         for (int i=(int)app.elements.size()-1;i>=0;i--)
             if (app.elements[i].n1==last||app.elements[i].n2==last)
-                app.elements.erase(app.elements.begin()+i);
+                { app.elements.erase(app.elements.begin()+i); markDirty(ARR_ELEMENTS, i); }
         for (int i=(int)app.forces.size()-1;i>=0;i--)
             if (app.forces[i].node==last)
-                app.forces.erase(app.forces.begin()+i);
+                { app.forces.erase(app.forces.begin()+i); markDirty(ARR_FORCES, i); }
         for (int i=(int)app.supports.size()-1;i>=0;i--)
             if (app.supports[i].node==last)
-                app.supports.erase(app.supports.begin()+i);
+                { app.supports.erase(app.supports.begin()+i); markDirty(ARR_SUPPORTS, i); }
+        for (int i=(int)app.timeLoads.size()-1;i>=0;i--)
+            if (app.timeLoads[i].node==last)
+                { app.timeLoads.erase(app.timeLoads.begin()+i); markDirty(ARR_TIMELOADS, i); }
         app.nodes.pop_back();
+        topologyChanged();
+        markDirty(ARR_NODES, last);   // novi cvor na istom mestu nije produzenje
+        clearSelection();
+        pickInvalidate();
         if (rmb_firstNode == last) rmb_firstNode = -1;
         if (pendingForceNode == last) pendingForceNode = -1;
         break;
@@ -672,7 +1381,7 @@ void keyboard(unsigned char key, int, int)
 
     case 'r': case 'R': camX=0.0f; camY=0.0f; camZoom=1.0f; break;
     }
-    glutPostRedisplay();
+    requestRedisplay();
 }
 
 // ─────────────────────────────────────────────
@@ -704,13 +1413,22 @@ void specialKeys(int key, int, int)
         if (key == GLUT_KEY_UP)   camY += panStep;
         else                      camY -= panStep;
     }
-    glutPostRedisplay();
+    requestRedisplay();
+}
+
+// ─────────────────────────────────────────────
+//  autosaveTimer
+// ─────────────────────────────────────────────
+static void autosaveTimer(int)
+{
+    autosaveTick();
+    glutTimerFunc(AUTOSAVE_PERIOD_MS, autosaveTimer, 0);
 }
 
 // ─────────────────────────────────────────────
 //  initWindow
 // ─────────────────────────────────────────────
-void initWindow(int argc, char** argv)
+void initWindow(int argc, char** argv, bool autosave)
 {
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB);
@@ -719,9 +1437,16 @@ void initWindow(int argc, char** argv)
 
     glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 
-    glutDisplayFunc(display);
-    glutReshapeFunc(reshape);
-    glutKeyboardFunc(keyboard);
-    glutSpecialFunc(specialKeys);
-    glutMouseFunc(handleMouse);
+    // Ulaz ide kroz omotace koji mere i (po potrebi) snimaju dogadjaje
+    glutDisplayFunc(inputDisplay);
+    glutReshapeFunc(inputReshape);
+    glutKeyboardFunc(inputKeyboard);
+    glutSpecialFunc(inputSpecial);
+    glutMouseFunc(inputMouse);
+    glutMotionFunc(inputMotion);
+
+    if (autosave) {
+        startAutosave();
+        glutTimerFunc(AUTOSAVE_PERIOD_MS, autosaveTimer, 0);
+    }
 }
@@ -3,13 +3,17 @@
 
 #include <GL/freeglut.h>
 
-void initWindow(int argc, char** argv);
+// autosave = false: bez pozadinskog cuvanja (ponavljanje traga ne sme da
+// prepise fajlove za oporavak)
+void initWindow(int argc, char** argv, bool autosave = true);
 
 void display();
 void reshape(int w, int h);
+void resizeView(int w, int h);   // kao reshape, bez GL poziva (headless)
 void keyboard(unsigned char key, int x, int y);
 void specialKeys(int key, int x, int y);
 void handleMouse(int button, int state, int x, int y);
+void handleMotion(int x, int y);
 
 void drawGrid();
 void drawTruss();
@@ -17,4 +21,7 @@ void drawForces();
 void drawSupports();
 void drawUI();
 
+// Crta model (bez legende) u tekuci GL kontekst, za offscreen renderovanje
+void renderView(float xMin, float xMax, float yMin, float yMax, int w, int h);
+
 #endif